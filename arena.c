@@ -0,0 +1,645 @@
+/*
+============================
+          arena.c
+   Many games in one window:
+   - Tiles N matches in a grid sized to the window; each tile maps the
+     referee's 800x600 scene into its cell with one scale and offset
+   - Matches come from in-process games (game_sim.c, one tick per
+     --tick-ms) or from running referees' shared views (--views=);
+     simulated games play by config.txt's rules (--config=)
+   - Builds every rope, player and score mark into vertex arrays and
+     draws the whole arena with three glDrawArrays calls per frame
+   - Reports frame time for the tile count; --grow doubles the tiles
+     every few seconds and prints a summary table
+   Usage: arena [options] [roster file]
+============================
+*/
+
+#define _GNU_SOURCE
+#include <GL/glut.h>
+#include "game_sim.h"
+#include "scene.h"
+#include "shared_view.h"
+#include "strategy.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <math.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#define ARENA_MAX_MATCHES 1024
+#define ARENA_MAX_SAMPLES 4096   // frames kept per report window
+
+// Part of the referee's scene shown in a tile (parent.c coordinates)
+#define MATCH_X0   0.0f
+#define MATCH_Y0   230.0f
+#define MATCH_W    SCENE_WIDTH
+#define MATCH_H    150.0f
+#define TILE_FILL  0.92f         // share of a grid cell used by its tile
+
+#define HOLD_TICKS 10            // ticks a finished simulated game stays on screen
+
+// ============================
+// Matches
+// ============================
+typedef struct {
+    ViewGame game;               // what this tile draws
+    float    shift;              // rope shift, eased toward the target every frame
+    float    target;
+    int      nodeCount;          // rope nodes from a windowed referee, 0 = straight rope
+    float    x[VIEW_MAX_NODES], y[VIEW_MAX_NODES];
+
+    // Source: one of these
+    SimGame*          sim;
+    int               hold;      // ticks left before a finished game restarts
+    unsigned          seed;
+    const SharedView* view;
+} Match;
+
+typedef struct {
+    float ox, oy;                // screen = o + scale * scene
+    float scale;
+} Tile;
+
+// Interleaved vertex for glVertexPointer / glColorPointer
+typedef struct {
+    float   x, y;
+    uint8_t rgba[4];
+} Vertex;
+
+typedef struct {
+    Vertex* v;
+    int     count, capacity;
+} Batch;
+
+static SimRules    gRules;                  // config.txt, then command-line overrides
+static SimRoster   gRoster;
+static const Strategy* gSides[SIM_MAX_PLAYERS];
+static Strategy    gStrategy;               // --strategy: Team 1's strategy
+static unsigned    gSeed       = 1;
+static const char* gViewPrefix = NULL;      // --views: "<prefix><k>" for k = 0..N-1
+
+static Match*      gMatches    = NULL;
+static int         gMatchCap   = 64;        // --matches
+static int         gTileCount  = 0;         // tiles shown (<= gMatchCap)
+static Tile*       gTiles      = NULL;
+static int         gWinW = 1280, gWinH = 800;
+
+static Batch       gTris, gLines, gPoints;
+static float       gPointSize  = 1.0f;
+
+static long        gTickMs     = 100;
+static int         gFps        = 60;        // 0 = uncapped
+static double      gGrowSecs   = 0.0;       // --grow: seconds per tile count
+static long long   gNextTickNs = 0;
+static long long   gNextFrameNs = 0;
+static long long   gNextMapNs  = 0;
+
+// Frame statistics of the current report window
+static double      gWorkMs[ARENA_MAX_SAMPLES];
+static int         gSamples    = 0;
+static double      gUpdateMs = 0, gBuildMs = 0, gDrawMs = 0;
+static long long   gWindowStartNs = 0, gFrames = 0;
+static char        gSummary[16][160];
+static int         gSummaryLines = 0;
+
+static long long nowNs(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (long long)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+// ----------------------------
+// Simulated matches
+// ----------------------------
+
+// Copy the referee-side state of a simulated game into the tile's snapshot
+static void publishSim(Match* m) {
+    const SimGame* s = m->sim;
+    const PlayerTable* t = &s->table;
+    ViewGame* g = &m->game;
+    g->roundNumber          = s->round;
+    g->roundInProgress      = s->inProgress;
+    g->scoreTeam1           = s->score1;
+    g->scoreTeam2           = s->score2;
+    g->consecutiveWinsTeam1 = s->streak1;
+    g->consecutiveWinsTeam2 = s->streak2;
+    g->maxRounds            = gRules.maxRounds;
+    g->winThreshold         = gRules.threshold;
+    g->sumTeam1             = (int32_t)s->sum1;
+    g->sumTeam2             = (int32_t)s->sum2;
+    g->playerCount          = t->count < VIEW_MAX_PLAYERS ? t->count : VIEW_MAX_PLAYERS;
+    for (int i = 0; i < g->playerCount; i++) {
+        g->energy[i] = t->energy[i];
+        g->team[i]   = (uint8_t)playerTeam(t, i);
+        g->factor[i] = (uint8_t)playerFactor(t, i);
+        g->fallen[i] = 0;
+    }
+    m->target = ROPE_SHIFT_PER_SUM * (float)(s->sum2 - s->sum1);
+}
+
+static void startSim(Match* m) {
+    simStart(m->sim, &gRules, gSides, m->seed);
+    m->game.gameOver = 0;
+    m->hold = HOLD_TICKS;
+    publishSim(m);
+}
+
+// One referee tick for every shown simulated match; finished games stay
+// on screen for HOLD_TICKS ticks, then restart on the next seed.
+static void tickSims(void) {
+    for (int k = 0; k < gTileCount; k++) {
+        Match* m = &gMatches[k];
+        if (!m->sim) continue;
+        if (simTick(m->sim)) {
+            publishSim(m);
+        } else if (!m->game.gameOver) {
+            m->game.gameOver = 1;
+        } else if (--m->hold <= 0) {
+            m->seed += gMatchCap;
+            startSim(m);
+        }
+    }
+}
+
+// ----------------------------
+// Shared views
+// ----------------------------
+
+// One non-blocking attempt to map a referee's view (NULL if not there yet)
+static const SharedView* tryMapView(const char* name) {
+    int fd = shm_open(name, O_RDONLY, 0);
+    if (fd == -1) {
+        if (errno != ENOENT) perror(name);
+        return NULL;
+    }
+    const SharedView* v = NULL;
+    struct stat st;
+    if (fstat(fd, &st) == 0 && st.st_size >= (off_t)sizeof(SharedView)) {
+        v = mmap(NULL, sizeof(SharedView), PROT_READ, MAP_SHARED, fd, 0);
+        if (v == MAP_FAILED) {
+            v = NULL;
+        } else if (__atomic_load_n(&v->magic, __ATOMIC_ACQUIRE) != VIEW_MAGIC ||
+                   v->version != VIEW_VERSION) {
+            munmap((void*)v, sizeof(SharedView));
+            v = NULL;
+        }
+    }
+    close(fd);
+    return v;
+}
+
+// Map views that were not there yet (at most once a second)
+static void mapMissingViews(long long now) {
+    if (now < gNextMapNs) return;
+    gNextMapNs = now + 1000000000LL;
+    for (int k = 0; k < gTileCount; k++) {
+        if (gMatches[k].view) continue;
+        char name[256];
+        snprintf(name, sizeof(name), "%s%d", gViewPrefix, k);
+        gMatches[k].view = tryMapView(name);
+        if (gMatches[k].view) printf("[Arena] Tile %d: %s\n", k, name);
+    }
+}
+
+// Seqlock snapshots of every shown view (no syscalls)
+static void readViews(void) {
+    ViewRope rope;
+    for (int k = 0; k < gTileCount; k++) {
+        Match* m = &gMatches[k];
+        if (!m->view) continue;
+        viewRead(&m->view->gameSeq, &m->view->game, &m->game, sizeof(m->game));
+        viewRead(&m->view->ropeSeq, &m->view->rope, &rope, sizeof(rope));
+        m->nodeCount = rope.nodeCount < VIEW_MAX_NODES ? rope.nodeCount : VIEW_MAX_NODES;
+        if (m->nodeCount) {
+            m->shift = rope.ropeShift;
+            memcpy(m->x, rope.x, m->nodeCount * sizeof(float));
+            memcpy(m->y, rope.y, m->nodeCount * sizeof(float));
+        } else {
+            // Headless referee: no rope simulation, use the tick's sums
+            m->target = ROPE_SHIFT_PER_SUM * (m->game.sumTeam2 - m->game.sumTeam1);
+        }
+    }
+}
+
+// ----------------------------
+// layoutArena
+// Pick the column count that gives the largest tiles for n matches in
+// a w x h window, then give each tile the scale and offset that maps
+// the scene rectangle (MATCH_X0, MATCH_Y0, MATCH_W x MATCH_H) into the
+// middle of its cell. Row 0 is at the top.
+// ----------------------------
+static void layoutArena(int n, int w, int h) {
+    int cols = 1;
+    float best = 0.0f;
+    for (int c = 1; c <= n; c++) {
+        int r = (n + c - 1) / c;
+        float s = fminf((float)w / (c * MATCH_W), (float)h / (r * MATCH_H));
+        if (s > best) {
+            best = s;
+            cols = c;
+        }
+    }
+    int rows = (n + cols - 1) / cols;
+    float cellW = (float)w / cols, cellH = (float)h / rows;
+    float s = best * TILE_FILL;
+    for (int k = 0; k < n; k++) {
+        int col = k % cols, row = k / cols;
+        gTiles[k].scale = s;
+        gTiles[k].ox = col * cellW + (cellW - s * MATCH_W) * 0.5f - s * MATCH_X0;
+        gTiles[k].oy = h - (row + 1) * cellH + (cellH - s * MATCH_H) * 0.5f - s * MATCH_Y0;
+    }
+    gPointSize = fmaxf(1.0f, 4.0f * s);
+    printf("[Arena] %d tiles: %d x %d grid, %.0f x %.0f px each\n", n, cols, rows,
+           s * MATCH_W, s * MATCH_H);
+}
+
+// ----------------------------
+// Vertex batches
+// ----------------------------
+static Vertex* reserve(Batch* b, int n) {
+    if (b->count + n > b->capacity) {
+        int cap = b->capacity ? b->capacity : 1024;
+        while (cap < b->count + n) cap *= 2;
+        Vertex* v = realloc(b->v, cap * sizeof(Vertex));
+        if (!v) {
+            perror("realloc");
+            exit(EXIT_FAILURE);
+        }
+        b->v = v;
+        b->capacity = cap;
+    }
+    Vertex* v = b->v + b->count;
+    b->count += n;
+    return v;
+}
+
+static inline void put(Vertex* v, const Tile* t, float x, float y, const uint8_t rgba[4]) {
+    v->x = t->ox + t->scale * x;
+    v->y = t->oy + t->scale * y;
+    memcpy(v->rgba, rgba, 4);
+}
+
+static const uint8_t kGreen[4]  = { 0, 255, 0, 255 };
+static const uint8_t kOrange[4] = { 255, 166, 0, 255 };
+static const uint8_t kYellow[4] = { 255, 255, 0, 255 };
+static const uint8_t kBlack[4]  = { 0, 0, 0, 255 };
+static const uint8_t kGray[4]   = { 128, 128, 128, 255 };
+static const uint8_t kRed[4]    = { 255, 0, 0, 255 };
+static const uint8_t kFrame[4]  = { 200, 200, 200, 255 };
+static const uint8_t kDone[4]   = { 90, 90, 220, 255 };
+
+// parent.c's setColorForEnergy
+static const uint8_t* energyColor(int32_t energy) {
+    if (energy >= ENERGY_GREEN)  return kGreen;
+    if (energy >= ENERGY_ORANGE) return kOrange;
+    if (energy >= ENERGY_YELLOW) return kYellow;
+    return kBlack;
+}
+
+// Unit circle for the Team 2 players, 16 segments
+static float gCircleX[17], gCircleY[17];
+
+static void initCircle(void) {
+    for (int j = 0; j <= 16; j++) {
+        gCircleX[j] = cosf(j * (float)M_PI / 8.0f);
+        gCircleY[j] = sinf(j * (float)M_PI / 8.0f);
+    }
+}
+
+// ----------------------------
+// buildMatch
+// Append one tile: frame, score marks, rope and players. Small tiles
+// get coarser circles (fewer segments than pixels of outline).
+// ----------------------------
+static void buildMatch(const Match* m, const Tile* t) {
+    const ViewGame* g = &m->game;
+    Vertex* v;
+
+    // Frame (blue once the game is over)
+    const uint8_t* frame = g->gameOver ? kDone : kFrame;
+    float fx[4] = { MATCH_X0, MATCH_X0 + MATCH_W, MATCH_X0 + MATCH_W, MATCH_X0 };
+    float fy[4] = { MATCH_Y0, MATCH_Y0, MATCH_Y0 + MATCH_H, MATCH_Y0 + MATCH_H };
+    v = reserve(&gLines, 8);
+    for (int c = 0; c < 4; c++) {
+        put(v++, t, fx[c], fy[c], frame);
+        put(v++, t, fx[(c + 1) % 4], fy[(c + 1) % 4], frame);
+    }
+
+    // Scores: one square per round won, Team 1 from the left, Team 2 from the right
+    int marks = g->scoreTeam1 + g->scoreTeam2;
+    v = reserve(&gTris, 6 * marks);
+    for (int k = 0; k < marks; k++) {
+        float x = k < g->scoreTeam1 ? 50.0f + k * 25.0f : 735.0f - (k - g->scoreTeam1) * 25.0f;
+        float y = 345.0f;
+        put(v++, t, x, y, kBlack);
+        put(v++, t, x + 15.0f, y, kBlack);
+        put(v++, t, x + 15.0f, y + 15.0f, kBlack);
+        put(v++, t, x, y, kBlack);
+        put(v++, t, x + 15.0f, y + 15.0f, kBlack);
+        put(v++, t, x, y + 15.0f, kBlack);
+    }
+
+    // Rope: the referee's nodes, or a straight rope moved by the shift
+    float offset = m->shift * ROPE_SHIFT_SCALE;
+    int nodes = m->nodeCount ? m->nodeCount : ROPE_NODES;
+    float rx[VIEW_MAX_NODES], ry[VIEW_MAX_NODES];
+    for (int i = 0; i < nodes; i++) {
+        rx[i] = m->nodeCount ? m->x[i] : ROPE_START_X + i * ROPE_LENGTH / (ROPE_NODES - 1) + offset;
+        ry[i] = m->nodeCount ? m->y[i] : SCENE_Y;
+    }
+    v = reserve(&gLines, 2 * (nodes - 1));
+    for (int i = 1; i < nodes; i++) {
+        put(v++, t, rx[i - 1], ry[i - 1], kRed);
+        put(v++, t, rx[i], ry[i], kRed);
+    }
+    v = reserve(&gPoints, nodes);
+    for (int i = 0; i < nodes; i++) put(v++, t, rx[i], ry[i], kRed);
+
+    // Players, placed like initPlayerSprites
+    float radius = PLAYER_SIZE * t->scale;
+    int step = radius >= 8.0f ? 1 : radius >= 3.0f ? 2 : 4;   // 16, 8 or 4 segments
+    int countTeam1 = 0, countTeam2 = 0;
+    for (int i = 0; i < g->playerCount; i++) {
+        float x = (g->team[i] == 1 ? TEAM1_START_X + PLAYER_SPACING * countTeam1++
+                                    : TEAM2_START_X - PLAYER_SPACING * countTeam2++) + offset;
+        float size = g->fallen[i] ? FALLEN_SCALE * PLAYER_SIZE : PLAYER_SIZE;
+        const uint8_t* color = g->fallen[i] ? kGray : energyColor(g->energy[i]);
+        if (g->team[i] == 1) {
+            v = reserve(&gTris, 3);
+            put(v++, t, x - size, SCENE_Y - size, color);
+            put(v++, t, x + size, SCENE_Y - size, color);
+            put(v++, t, x, SCENE_Y + size, color);
+        } else {
+            v = reserve(&gTris, 3 * (16 / step));
+            for (int j = 0; j < 16; j += step) {
+                put(v++, t, x, SCENE_Y, color);
+                put(v++, t, x + size * gCircleX[j], SCENE_Y + size * gCircleY[j], color);
+                put(v++, t, x + size * gCircleX[j + step], SCENE_Y + size * gCircleY[j + step], color);
+            }
+        }
+    }
+}
+
+static void drawBatch(const Batch* b, GLenum mode) {
+    if (!b->count) return;
+    glVertexPointer(2, GL_FLOAT, sizeof(Vertex), &b->v->x);
+    glColorPointer(4, GL_UNSIGNED_BYTE, sizeof(Vertex), b->v->rgba);
+    glDrawArrays(mode, 0, b->count);
+}
+
+// ----------------------------
+// Frame statistics
+// ----------------------------
+static int compareDouble(const void* a, const void* b) {
+    double x = *(const double*)a, y = *(const double*)b;
+    return (x > y) - (x < y);
+}
+
+// One line per report window; `final` also keeps it for the --grow summary
+static void reportFrames(long long now, int final) {
+    if (!gSamples) return;
+    double secs = (now - gWindowStartNs) / 1e9;
+    double sum = 0.0;
+    for (int i = 0; i < gSamples; i++) sum += gWorkMs[i];
+    qsort(gWorkMs, gSamples, sizeof(double), compareDouble);
+    char line[160];
+    snprintf(line, sizeof(line),
+             "%5d tiles  %7.1f fps  frame %6.3f ms avg %6.3f p99 %6.3f max  "
+             "(update %.3f, build %.3f, draw %.3f)  %d vertices",
+             gTileCount, gFrames / secs, sum / gSamples, gWorkMs[(int)(gSamples * 0.99)],
+             gWorkMs[gSamples - 1], gUpdateMs / gSamples, gBuildMs / gSamples, gDrawMs / gSamples,
+             gTris.count + gLines.count + gPoints.count);
+    printf("[Arena] %s\n", line);
+    fflush(stdout);
+    if (final && gSummaryLines < 16) strcpy(gSummary[gSummaryLines++], line);
+    char title[96];
+    snprintf(title, sizeof(title), "Rope Pulling Arena - %d matches, %.2f ms/frame", gTileCount,
+             sum / gSamples);
+    glutSetWindowTitle(title);
+    gSamples = 0;
+    gFrames = 0;
+    gUpdateMs = gBuildMs = gDrawMs = 0.0;
+    gWindowStartNs = now;
+}
+
+static void setTileCount(int n) {
+    if (n < 1) n = 1;
+    if (n > gMatchCap) n = gMatchCap;
+    if (n == gTileCount) return;
+    for (int k = gTileCount; k < n; k++) {
+        if (gMatches[k].sim) startSim(&gMatches[k]);
+    }
+    gTileCount = n;
+    gNextMapNs = 0;
+    layoutArena(gTileCount, gWinW, gWinH);
+    gSamples = 0;
+    gFrames = 0;
+    gUpdateMs = gBuildMs = gDrawMs = 0.0;
+    gWindowStartNs = nowNs();
+}
+
+// ============================
+// GLUT callbacks
+// ============================
+void display() {
+    long long start = nowNs();
+
+    // Update: simulated ticks, view snapshots, rope easing (as updateScene)
+    if (gViewPrefix) {
+        mapMissingViews(start);
+        readViews();
+    } else {
+        if (start - gNextTickNs > 1000000000LL) gNextTickNs = start;   // stalled: do not replay
+        while (start >= gNextTickNs) {
+            tickSims();
+            gNextTickNs += gTickMs * 1000000LL;
+        }
+    }
+    for (int k = 0; k < gTileCount; k++) {
+        Match* m = &gMatches[k];
+        if (m->nodeCount) continue;
+        m->shift += (m->target - m->shift) * 0.1f;
+        if (fabsf(m->target - m->shift) < 0.01f) m->shift = m->target;
+    }
+    long long built = nowNs();
+
+    // Build: every tile into the three batches
+    gTris.count = gLines.count = gPoints.count = 0;
+    for (int k = 0; k < gTileCount; k++) buildMatch(&gMatches[k], &gTiles[k]);
+    long long drawn = nowNs();
+
+    // Draw: three calls for the whole arena
+    glClear(GL_COLOR_BUFFER_BIT);
+    drawBatch(&gTris, GL_TRIANGLES);
+    drawBatch(&gLines, GL_LINES);
+    glPointSize(gPointSize);
+    drawBatch(&gPoints, GL_POINTS);
+    glutSwapBuffers();
+    long long end = nowNs();
+
+    if (gSamples < ARENA_MAX_SAMPLES) gWorkMs[gSamples++] = (end - start) / 1e6;
+    gUpdateMs += (built - start) / 1e6;
+    gBuildMs  += (drawn - built) / 1e6;
+    gDrawMs   += (end - drawn) / 1e6;
+    gFrames++;
+}
+
+void reshape(int w, int h) {
+    gWinW = w > 0 ? w : 1;
+    gWinH = h > 0 ? h : 1;
+    glViewport(0, 0, gWinW, gWinH);
+    glMatrixMode(GL_PROJECTION);
+    glLoadIdentity();
+    gluOrtho2D(0, gWinW, 0, gWinH);
+    layoutArena(gTileCount, gWinW, gWinH);
+}
+
+void keyboard(unsigned char key, int x, int y) {
+    (void)x;
+    (void)y;
+    if (key == '+' || key == '=') setTileCount(gTileCount * 2);
+    else if (key == '-') setTileCount(gTileCount / 2);
+    else if (key == 'q' || key == 27) exit(0);
+}
+
+// Report every 2 s (or at each --grow step), then pace to --fps
+void idle() {
+    long long now = nowNs();
+    if (gGrowSecs > 0.0) {
+        if (now - gWindowStartNs >= (long long)(gGrowSecs * 1e9)) {
+            reportFrames(now, 1);
+            if (gTileCount >= gMatchCap) {
+                printf("[Arena] Frame time by tile count:\n");
+                for (int i = 0; i < gSummaryLines; i++) printf("  %s\n", gSummary[i]);
+                exit(0);
+            }
+            setTileCount(gTileCount * 2);
+        }
+    } else if (now - gWindowStartNs >= 2000000000LL) {
+        reportFrames(now, 0);
+    }
+    if (gFps > 0) {
+        if (now < gNextFrameNs) {
+            long long wait = gNextFrameNs - now;
+            struct timespec ts = { wait / 1000000000LL, wait % 1000000000LL };
+            nanosleep(&ts, NULL);
+            now = gNextFrameNs;
+        }
+        gNextFrameNs = now + 1000000000LL / gFps;
+    }
+    glutPostRedisplay();
+}
+
+static void usage(const char* prog) {
+    fprintf(stderr,
+            "Usage: %s [options] [roster file]\n"
+            "  --matches=N (64)     tiles in the arena (up to %d)\n"
+            "  --views=PREFIX       show running referees' views PREFIX0..PREFIX<N-1>\n"
+            "                       instead of simulated games\n"
+            "  --tick-ms=N (100)    simulated tick length\n"
+            "  --fps=N (60)         frame cap, 0 = uncapped\n"
+            "  --grow[=S]           start at 1 tile and double every S s (3), then exit\n"
+            "  --strategy=FILE      Team 1's strategy in simulated games  --seed=N (1)\n"
+            "  --config=FILE (config.txt)  game rules as the referee reads them; these override it:\n"
+            "  --threshold=N  --max-rounds=N  --consecutive=N  --round-ticks=N\n"
+            "  --depletion-min=N  --depletion-max=N\n"
+            "  Keys: '+' / '-' double / halve the tiles, 'q' quits\n",
+            prog, ARENA_MAX_MATCHES);
+    exit(EXIT_FAILURE);
+}
+
+int main(int argc, char* argv[]) {
+    glutInit(&argc, argv);
+
+    const char* rosterFile = "playersConfiguration.txt";
+    const char* strategyFile = NULL;
+    const char* configFile = "config.txt";
+    for (int i = 1; i < argc; i++) {
+        if (strncmp(argv[i], "--config=", 9) == 0) configFile = argv[i] + 9;
+    }
+    GameConfig cfg;
+    initGameConfig(&cfg);
+    if (loadGameConfig(&cfg, configFile) == -1) exit(EXIT_FAILURE);
+    simRulesFromConfig(&gRules, &cfg);
+
+    for (int i = 1; i < argc; i++) {
+        const char* a = argv[i];
+        const char* v = strchr(a, '=');
+        v = v ? v + 1 : "";
+        if      (strncmp(a, "--matches=", 10) == 0)       gMatchCap = atoi(v);
+        else if (strncmp(a, "--views=", 8) == 0)          gViewPrefix = v;
+        else if (strncmp(a, "--tick-ms=", 10) == 0)       gTickMs = atol(v);
+        else if (strncmp(a, "--fps=", 6) == 0)            gFps = atoi(v);
+        else if (strcmp(a, "--grow") == 0)                gGrowSecs = 3.0;
+        else if (strncmp(a, "--grow=", 7) == 0)           gGrowSecs = atof(v);
+        else if (strncmp(a, "--strategy=", 11) == 0)      strategyFile = v;
+        else if (strncmp(a, "--seed=", 7) == 0)           gSeed = (unsigned)strtoul(v, NULL, 10);
+        else if (strncmp(a, "--threshold=", 12) == 0)     gRules.threshold = atoi(v);
+        else if (strncmp(a, "--max-rounds=", 13) == 0)    gRules.maxRounds = atoi(v);
+        else if (strncmp(a, "--consecutive=", 14) == 0)   gRules.consecutive = atoi(v);
+        else if (strncmp(a, "--round-ticks=", 14) == 0)   gRules.roundTicks = atoi(v);
+        else if (strncmp(a, "--depletion-min=", 16) == 0) gRules.depletionMin = atoi(v);
+        else if (strncmp(a, "--depletion-max=", 16) == 0) gRules.depletionMax = atoi(v);
+        else if (strncmp(a, "--config=", 9) == 0)         continue;   // loaded above
+        else if (a[0] != '-')                             rosterFile = a;
+        else                                              usage(argv[0]);
+    }
+    if (gMatchCap < 1 || gMatchCap > ARENA_MAX_MATCHES || gTickMs < 1 || gFps < 0 ||
+        gRules.roundTicks < 1 || gRules.depletionMin < 0 || gRules.depletionMax < gRules.depletionMin) {
+        usage(argv[0]);
+    }
+
+    gMatches = calloc(gMatchCap, sizeof(Match));
+    gTiles   = calloc(gMatchCap, sizeof(Tile));
+    if (!gMatches || !gTiles) {
+        perror("calloc");
+        exit(EXIT_FAILURE);
+    }
+    if (!gViewPrefix) {
+        if (readSimRoster(rosterFile, &gRoster) == -1) {
+            fprintf(stderr, "No players in roster %s\n", rosterFile);
+            exit(EXIT_FAILURE);
+        }
+        if (strategyFile) {
+            if (loadStrategy(strategyFile, &gStrategy) == -1) exit(EXIT_FAILURE);
+            for (int i = 0; i < gRoster.count; i++) {
+                if (gRoster.team[i] == 1) gSides[i] = &gStrategy;
+            }
+        }
+        for (int k = 0; k < gMatchCap; k++) {
+            gMatches[k].sim  = malloc(sizeof(SimGame));
+            gMatches[k].seed = gSeed + (unsigned)k;
+            if (!gMatches[k].sim || simInit(gMatches[k].sim, &gRoster) == -1) {
+                fprintf(stderr, "Out of memory for %d matches\n", gMatchCap);
+                exit(EXIT_FAILURE);
+            }
+        }
+    }
+    initCircle();
+
+    glutInitDisplayMode(GLUT_DOUBLE | GLUT_RGB);
+    glutInitWindowSize(gWinW, gWinH);
+    glutCreateWindow("Rope Pulling Arena");
+    glClearColor(1, 1, 1, 1);
+    glEnableClientState(GL_VERTEX_ARRAY);
+    glEnableClientState(GL_COLOR_ARRAY);
+
+    printf("[Arena] %s, up to %d matches%s\n",
+           gViewPrefix ? "Shared views" : "Simulated games", gMatchCap,
+           gGrowSecs > 0.0 ? ", growing from 1" : "");
+    gNextTickNs = nowNs();
+    setTileCount(gGrowSecs > 0.0 ? 1 : gMatchCap);
+
+    glutDisplayFunc(display);
+    glutReshapeFunc(reshape);
+    glutKeyboardFunc(keyboard);
+    glutIdleFunc(idle);
+    glutMainLoop();
+    return 0;
+}
@@ -0,0 +1,82 @@
+#ifndef CHECKPOINT_H
+#define CHECKPOINT_H
+
+/*
+  checkpoint.h
+  ------------
+  Versioned binary snapshot of an in-progress game, so a restarted
+  referee can pick up where the last one stopped (--resume).
+
+  One fixed-size little-endian record: a header with a checksum, the
+  referee's game state and round phase, every player as the referee
+  sees it plus the state its process last reported (energy before the
+  factor, factor, fallen), and the rope. The referee writes it at the
+  end of every round to "<file>.tmp" and renames it over <file>, so a
+  reader only ever sees a complete snapshot.
+*/
+
+#include <stdint.h>
+
+#define CHECKPOINT_MAGIC       0x50435052u  // "RPCP"
+#define CHECKPOINT_VERSION     2
+#define CHECKPOINT_MAX_PLAYERS 8
+#define CHECKPOINT_MAX_NODES   64
+
+// ============================
+// Record layout
+// ============================
+typedef struct {
+    int32_t id;
+    int32_t energy;          // referee view (effective energy of the last tick)
+    uint8_t flags;           // PlayerTable flags: factor, fallen, team
+    uint8_t reportedFallen;  // process state from its last energy report
+    uint8_t reportedFactor;
+    uint8_t pad;
+    int32_t reportedEnergy;  // process energy after its last tick (ReportRecord.ownEnergy)
+    int32_t rosterEnergy;    // energy a replacement starts with
+    int32_t crashes;         // counts against max_respawns
+} CheckpointPlayer;
+
+typedef struct {
+    float x, y;
+    float vx, vy;
+} CheckpointNode;
+
+typedef struct {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t size;            // sizeof(Checkpoint)
+    uint32_t checksum;        // FNV-1a of everything after this header
+
+    // Game and round phase
+    int64_t  savedAtNs;       // CLOCK_REALTIME
+    int32_t  gameId, rosterHash;
+    int32_t  roundNumber;
+    int32_t  scoreTeam1, scoreTeam2;
+    int32_t  consecutiveWinsTeam1, consecutiveWinsTeam2;
+    int32_t  winThreshold, maxRounds, consecutiveWinLimit;
+    int32_t  sumTeam1, sumTeam2;
+    int32_t  roundInProgress;
+    int32_t  roundTick;       // ticks elapsed in the current round
+    int32_t  totalTicks;
+    uint32_t tickSeq;
+
+    // Players
+    int32_t  playerCount;
+    CheckpointPlayer players[CHECKPOINT_MAX_PLAYERS];
+
+    // Rope (nodeCount = 0 when saved without a window)
+    float    ropeShift, ropeTargetShift;
+    int32_t  nodeCount;
+    CheckpointNode nodes[CHECKPOINT_MAX_NODES];
+} Checkpoint;
+
+_Static_assert(sizeof(Checkpoint) == 1320, "Checkpoint layout changed: bump CHECKPOINT_VERSION");
+
+// ============================
+// Function Prototypes
+// ============================
+int saveCheckpoint(const char* path, Checkpoint* cp);
+int loadCheckpoint(const char* path, Checkpoint* cp);
+
+#endif // CHECKPOINT_H
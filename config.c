@@ -0,0 +1,281 @@
+/*
+============================
+         config.c
+   Referee runtime settings:
+   - Defaults matching the original fixed timings
+   - "key = value" parsing for config.txt
+   - "--key=value" command-line overrides
+============================
+*/
+
+#define _GNU_SOURCE
+#include "config.h"
+#include "sched_tune.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <math.h>
+
+#define NS_PER_MS 1000000.0
+
+// ----------------------------
+// initGameConfig
+// Defaults reproduce the original behaviour:
+// 1 s ticks, 10-tick rounds, 1.5 s warm-up, 10 ms settle.
+// ----------------------------
+void initGameConfig(GameConfig* cfg) {
+    cfg->tickIntervalNs  = 1000000000LL;
+    cfg->roundTimeoutNs  = 10000000000LL;
+    cfg->warmupNs        = 1500000000LL;
+    cfg->settleNs        = 10000000LL;
+    cfg->timeCompression = 1.0;
+    cfg->reportTimeoutNs = 100000000LL;
+    cfg->reportCoalesceNs = 50000LL;
+    cfg->maxRespawns     = 5;
+    cfg->winThreshold    = 0;
+    cfg->maxRounds       = 0;
+    cfg->consecutiveWins = 0;
+    cfg->depletionMin    = 5;
+    cfg->depletionMax    = 14;
+    cfg->seed            = 0;
+    cfg->headless        = 0;
+    cfg->playersFile     = "PlayersConfiguration.txt";
+    cfg->resultsFile     = NULL;
+    cfg->refereeCpus     = NULL;
+    cfg->renderCpus      = NULL;
+    cfg->playerCpus      = NULL;
+    cfg->rtPriority      = 0;
+    cfg->playerRtPriority = 0;
+    cfg->traceFile       = NULL;
+    cfg->viewName        = NULL;
+    cfg->checkpointFile  = NULL;
+    cfg->resumeFile      = NULL;
+    cfg->listenAddr      = NULL;
+    cfg->spawnPlayers    = 1;
+    cfg->ropeIterations  = 8;
+    cfg->ropeTolerance   = 1e-3;
+    cfg->ropeSleepSpeed  = 0.01;
+}
+
+// ----------------------------
+// parseMs
+// Durations are written in milliseconds and may be fractional
+// ("0.25" = 250 us). Returns -1 on a malformed or negative value.
+// ----------------------------
+static long long parseMs(const char* value) {
+    char* end = NULL;
+    double ms = strtod(value, &end);
+    if (end == value || *end != '\0' || ms < 0.0) return -1;
+    return llround(ms * NS_PER_MS);
+}
+
+// ----------------------------
+// cpuListValue
+// Copy of a valid cpuset list ("0,2-3"); NULL if empty or malformed.
+// ----------------------------
+static const char* cpuListValue(const char* value) {
+    cpu_set_t set;
+    if (!*value || parseCpuList(value, &set) == -1) return NULL;
+    return strdup(value);
+}
+
+// ----------------------------
+// setConfigValue
+// Keys accept '-' or '_' as separator (tick-ms == tick_ms).
+// Returns 0 on success, -1 on an unknown key or bad value.
+// ----------------------------
+int setConfigValue(GameConfig* cfg, const char* key, const char* value) {
+    char norm[64];
+    size_t n = strlen(key);
+    if (n >= sizeof(norm)) return -1;
+    for (size_t i = 0; i <= n; i++) {
+        norm[i] = (key[i] == '-') ? '_' : key[i];
+    }
+
+    long long ns;
+    if (strcmp(norm, "tick_ms") == 0) {
+        if ((ns = parseMs(value)) <= 0) return -1;
+        cfg->tickIntervalNs = ns;
+    } else if (strcmp(norm, "round_timeout_ms") == 0) {
+        if ((ns = parseMs(value)) <= 0) return -1;
+        cfg->roundTimeoutNs = ns;
+    } else if (strcmp(norm, "warmup_ms") == 0) {
+        if ((ns = parseMs(value)) < 0) return -1;
+        cfg->warmupNs = ns;
+    } else if (strcmp(norm, "settle_ms") == 0) {
+        if ((ns = parseMs(value)) < 0) return -1;
+        cfg->settleNs = ns;
+    } else if (strcmp(norm, "time_compression") == 0) {
+        double c = atof(value);
+        if (c <= 0.0) return -1;
+        cfg->timeCompression = c;
+    } else if (strcmp(norm, "report_timeout_ms") == 0) {
+        if ((ns = parseMs(value)) <= 0) return -1;
+        cfg->reportTimeoutNs = ns;
+    } else if (strcmp(norm, "report_coalesce_ms") == 0) {
+        if ((ns = parseMs(value)) < 0) return -1;
+        cfg->reportCoalesceNs = ns;
+    } else if (strcmp(norm, "max_respawns") == 0) {
+        cfg->maxRespawns = atoi(value);
+    } else if (strcmp(norm, "win_threshold") == 0) {
+        if ((cfg->winThreshold = atoi(value)) < 0) return -1;
+    } else if (strcmp(norm, "max_rounds") == 0) {
+        if ((cfg->maxRounds = atoi(value)) < 0) return -1;
+    } else if (strcmp(norm, "consecutive_wins") == 0) {
+        if ((cfg->consecutiveWins = atoi(value)) < 0) return -1;
+    } else if (strcmp(norm, "depletion_min") == 0) {
+        if ((cfg->depletionMin = atoi(value)) < 0) return -1;
+    } else if (strcmp(norm, "depletion_max") == 0) {
+        if ((cfg->depletionMax = atoi(value)) < 0) return -1;
+    } else if (strcmp(norm, "seed") == 0) {
+        cfg->seed = (unsigned)strtoul(value, NULL, 10);
+    } else if (strcmp(norm, "headless") == 0) {
+        cfg->headless = atoi(value) != 0;
+    } else if (strcmp(norm, "players") == 0) {
+        cfg->playersFile = strdup(value);
+    } else if (strcmp(norm, "results") == 0) {
+        cfg->resultsFile = *value ? strdup(value) : NULL;
+    } else if (strcmp(norm, "trace") == 0) {
+        cfg->traceFile = *value ? strdup(value) : NULL;
+    } else if (strcmp(norm, "view") == 0) {
+        cfg->viewName = *value ? strdup(value) : NULL;
+    } else if (strcmp(norm, "checkpoint") == 0) {
+        cfg->checkpointFile = *value ? strdup(value) : NULL;
+    } else if (strcmp(norm, "resume") == 0) {
+        cfg->resumeFile = *value ? strdup(value) : NULL;
+    } else if (strcmp(norm, "listen") == 0) {
+        cfg->listenAddr = *value ? strdup(value) : NULL;
+    } else if (strcmp(norm, "spawn_players") == 0) {
+        cfg->spawnPlayers = atoi(value) != 0;
+    } else if (strcmp(norm, "rope_iterations") == 0) {
+        if ((cfg->ropeIterations = atoi(value)) < 1) return -1;
+    } else if (strcmp(norm, "rope_tolerance") == 0) {
+        if ((cfg->ropeTolerance = atof(value)) < 0.0) return -1;
+    } else if (strcmp(norm, "rope_sleep_speed") == 0) {
+        if ((cfg->ropeSleepSpeed = atof(value)) < 0.0) return -1;
+    } else if (strcmp(norm, "referee_cpus") == 0) {
+        if (!(cfg->refereeCpus = cpuListValue(value)) && *value) return -1;
+    } else if (strcmp(norm, "render_cpus") == 0) {
+        if (!(cfg->renderCpus = cpuListValue(value)) && *value) return -1;
+    } else if (strcmp(norm, "player_cpus") == 0) {
+        if (!(cfg->playerCpus = cpuListValue(value)) && *value) return -1;
+    } else if (strcmp(norm, "rt_priority") == 0) {
+        if ((cfg->rtPriority = atoi(value)) < 0 || cfg->rtPriority > 99) return -1;
+    } else if (strcmp(norm, "player_rt_priority") == 0) {
+        if ((cfg->playerRtPriority = atoi(value)) < 0 || cfg->playerRtPriority > 99) return -1;
+    } else {
+        return -1;
+    }
+    return 0;
+}
+
+// ----------------------------
+// trim
+// Strip leading/trailing whitespace in place.
+// ----------------------------
+static char* trim(char* s) {
+    while (isspace((unsigned char)*s)) s++;
+    char* end = s + strlen(s);
+    while (end > s && isspace((unsigned char)end[-1])) end--;
+    *end = '\0';
+    return s;
+}
+
+// ----------------------------
+// loadGameConfig
+// Reads "key = value" lines; '#' starts a comment.
+// A missing file is not an error (defaults stay in place).
+// ----------------------------
+int loadGameConfig(GameConfig* cfg, const char* filename) {
+    FILE* fp = fopen(filename, "r");
+    if (!fp) return 0;
+
+    char line[256];
+    int lineNo = 0;
+    int errors = 0;
+    while (fgets(line, sizeof(line), fp)) {
+        lineNo++;
+        char* hash = strchr(line, '#');
+        if (hash) *hash = '\0';
+        char* eq = strchr(line, '=');
+        if (!eq) {
+            if (*trim(line) != '\0') {
+                fprintf(stderr, "[Referee] %s:%d: expected key = value\n", filename, lineNo);
+                errors++;
+            }
+            continue;
+        }
+        *eq = '\0';
+        char* key = trim(line);
+        char* value = trim(eq + 1);
+        if (setConfigValue(cfg, key, value) == -1) {
+            fprintf(stderr, "[Referee] %s:%d: bad setting '%s'\n", filename, lineNo, key);
+            errors++;
+        }
+    }
+    fclose(fp);
+    return errors ? -1 : 0;
+}
+
+// ----------------------------
+// parseGameArgs
+// Accepts, in order:
+//   --config=<file>   load a settings file (later options override it)
+//   --<key>=<value>   any key understood by setConfigValue
+//   --headless        shorthand for --headless=1
+//   <file>            player roster (kept for "./parent roster.txt")
+// Returns 0 on success, -1 on the first bad argument.
+// ----------------------------
+int parseGameArgs(GameConfig* cfg, int argc, char** argv) {
+    for (int i = 1; i < argc; i++) {
+        const char* arg = argv[i];
+        if (strncmp(arg, "--", 2) != 0) {
+            cfg->playersFile = arg;
+            continue;
+        }
+
+        char key[64];
+        const char* eq = strchr(arg + 2, '=');
+        size_t keyLen = eq ? (size_t)(eq - (arg + 2)) : strlen(arg + 2);
+        if (keyLen >= sizeof(key)) {
+            fprintf(stderr, "[Referee] Unknown option %s\n", arg);
+            return -1;
+        }
+        memcpy(key, arg + 2, keyLen);
+        key[keyLen] = '\0';
+        const char* value = eq ? eq + 1 : "1";
+
+        if (strcmp(key, "config") == 0) {
+            if (loadGameConfig(cfg, value) == -1) return -1;
+        } else if (setConfigValue(cfg, key, value) == -1) {
+            fprintf(stderr, "[Referee] Unknown option or bad value: %s\n", arg);
+            return -1;
+        }
+    }
+    if (cfg->depletionMin > cfg->depletionMax) {
+        fprintf(stderr, "[Referee] depletion_min (%d) is above depletion_max (%d)\n",
+                cfg->depletionMin, cfg->depletionMax);
+        return -1;
+    }
+    return 0;
+}
+
+// ----------------------------
+// configWallNs
+// Convert a game-time duration to wall-clock nanoseconds.
+// ----------------------------
+long long configWallNs(const GameConfig* cfg, long long gameNs) {
+    long long ns = llround((double)gameNs / cfg->timeCompression);
+    return ns > 0 ? ns : (gameNs > 0 ? 1 : 0);
+}
+
+// ----------------------------
+// configRoundTicks
+// Number of ticks before a round ends with no winner
+// (10 with the default 1 s tick and 10 s timeout).
+// ----------------------------
+int configRoundTicks(const GameConfig* cfg) {
+    long long ticks = (cfg->roundTimeoutNs + cfg->tickIntervalNs - 1) / cfg->tickIntervalNs;
+    return ticks > 0 ? (int)ticks : 1;
+}
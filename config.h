@@ -0,0 +1,63 @@
+#ifndef CONFIG_H
+#define CONFIG_H
+
+/*
+  config.h
+  --------
+  Referee runtime settings.
+  Values come from config.txt ("key = value" lines) and can be
+  overridden on the command line with "--key=value".
+*/
+
+// ============================
+// GameConfig Structure
+// All durations are in nanoseconds of *game* time; the wall-clock
+// duration is divided by timeCompression, so the number of ticks
+// per round is the same at any speed.
+// ============================
+typedef struct {
+    long long   tickIntervalNs;   // Length of one referee tick (default 1 s)
+    long long   roundTimeoutNs;   // No-winner cutoff for a round (default 10 s)
+    long long   warmupNs;         // Delay before the first tick (default 1.5 s)
+    long long   settleNs;         // Pause after START_PULLING before reordering (default 10 ms)
+    double      timeCompression;  // Wall-clock speed-up factor (1 = real time)
+    long long   reportTimeoutNs;  // Wall-clock wait for energy reports per tick (not compressed)
+    long long   reportCoalesceNs; // Wall-clock batching window before draining report pipes
+    int         maxRespawns;      // Crashes tolerated per player before it stays fallen
+    int         winThreshold;     // 0 = game logic default (500)
+    int         maxRounds;        // 0 = game logic default (5)
+    int         consecutiveWins;  // 0 = game logic default (2)
+    int         depletionMin;     // Energy a player loses per START_PULLING (default 5..14)
+    int         depletionMax;
+    unsigned    seed;             // Player RNG seed, 0 = seed from the clock
+    int         headless;         // 1 = no GLUT window, exit when the game is over
+    const char* playersFile;      // Player roster (ID, team, energy)
+    const char* resultsFile;      // Columnar results file to append to (NULL = off)
+    const char* refereeCpus;      // CPU list for the referee thread (NULL = any)
+    const char* renderCpus;       // CPU list for the GLUT render thread (NULL = any)
+    const char* playerCpus;       // CPUs handed out round-robin to players (NULL = any)
+    int         rtPriority;       // SCHED_FIFO priority of the referee thread, 0 = off
+    int         playerRtPriority; // SCHED_FIFO priority of the players, 0 = off
+    const char* traceFile;        // Chrome trace JSON written at exit (NULL = off)
+    const char* viewName;         // Shared-memory spectator view, e.g. "/rope-game" (NULL = off)
+    const char* checkpointFile;   // Game checkpoint rewritten after every round (NULL = off)
+    const char* resumeFile;       // Checkpoint to resume from ("1" = checkpointFile, NULL = new game)
+    const char* listenAddr;       // Player socket, "unix:<path>" or "tcp:<host>:<port>" (NULL = pipes and signals)
+    int         spawnPlayers;     // 0 = players are started elsewhere and connect to listenAddr
+    int         ropeIterations;   // Max rope constraint passes per frame
+    double      ropeTolerance;    // Stop early once the worst link is within this fraction of its length
+    double      ropeSleepSpeed;   // px/frame under which a settled rope stops simulating
+} GameConfig;
+
+// ============================
+// Function Prototypes
+// ============================
+void initGameConfig(GameConfig* cfg);
+int  setConfigValue(GameConfig* cfg, const char* key, const char* value);
+int  loadGameConfig(GameConfig* cfg, const char* filename);
+int  parseGameArgs(GameConfig* cfg, int argc, char** argv);
+
+long long configWallNs(const GameConfig* cfg, long long gameNs);
+int       configRoundTicks(const GameConfig* cfg);
+
+#endif // CONFIG_H
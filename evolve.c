@@ -0,0 +1,349 @@
+/*
+============================
+          evolve.c
+   Evolutionary optimizer for player strategies:
+   - Evaluates each candidate strategy in-process (game_sim.c) against
+     a baseline opponent and the best strategies of earlier generations,
+     playing both sides of the roster over many seeded games
+   - Spreads candidates over --threads worker threads; every candidate
+     of a generation plays the same seeds, so the results do not depend
+     on the thread count
+   - Plays by the referee's rules from config.txt (--config=), with
+     the rule flags on top
+   - Breeds the next generation by elitism, tournament selection,
+     uniform crossover and Gaussian mutation
+   - Writes the best strategy for players to load with --strategy=<file>
+   Usage: evolve [options] <roster file>
+============================
+*/
+
+#define _GNU_SOURCE
+#include "game_sim.h"
+#include "strategy.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <pthread.h>
+#include <time.h>
+#include <unistd.h>
+
+#define MAX_HALL      8    // earlier generation bests kept as opponents
+#define TOURNAMENT    3
+
+// Search range of each weight (bias, energy, factor, round, lead)
+static const double gWeightLo[STRATEGY_WEIGHTS] = { 0.0, -2.0, -2.0, -2.0, -2.0 };
+static const double gWeightHi[STRATEGY_WEIGHTS] = { STRATEGY_EFFORT_MAX, 2.0, 2.0, 2.0, 2.0 };
+
+typedef struct {
+    Strategy strategy;
+    double   fitness;     // mean points per game (win 1, draw 0.5, loss 0)
+} Candidate;
+
+static SimRules    gRules;      // config.txt, then command-line overrides
+static SimRoster   gRoster;
+static int         gPopulation  = 48;
+static int         gGenerations = 30;
+static int         gGames       = 64;     // per opponent, split over both sides
+static int         gThreads     = 0;
+static int         gElite       = 4;
+static double      gSigma       = 0.15;   // mutation step (fraction of each weight's range)
+static unsigned    gSeed        = 1;
+static const char* gOutFile     = "best.strategy";
+static const char* gEvalFile    = NULL;   // --evaluate: score one strategy and exit
+
+static Strategy    gBaseline;             // --opponent (default strategy if unset)
+static Strategy    gHall[MAX_HALL];
+static int         gHallCount   = 0;
+
+// Work shared with the evaluation threads for one generation
+static Candidate*  gCandidates  = NULL;
+static int         gCandidateCount = 0;
+static int         gNextCandidate  = 0;
+static unsigned    gGenSeed        = 0;
+
+static double* weightAt(Strategy* s, int k) {
+    return (double*)s + k;   // Strategy is STRATEGY_WEIGHTS doubles in a row
+}
+
+static long long nowNs(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (long long)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+// ----------------------------
+// Random numbers for breeding (main thread only)
+// ----------------------------
+static uint64_t gRng = 0x9e3779b97f4a7c15ULL;
+
+static double uniform(void) {
+    gRng ^= gRng << 13;
+    gRng ^= gRng >> 7;
+    gRng ^= gRng << 17;
+    return (gRng >> 11) * (1.0 / 9007199254740992.0);
+}
+
+static double gaussian(void) {
+    double u = uniform(), v = uniform();
+    return sqrt(-2.0 * log(u + 1e-300)) * cos(2.0 * M_PI * v);
+}
+
+// ----------------------------
+// playMatch
+// `games` games of a against b: even games a plays Team 1 (b Team 2),
+// odd games the sides swap. Returns a's points.
+// ----------------------------
+static double playMatch(SimGame* sim, const Strategy* a, const Strategy* b, unsigned seed, int games) {
+    const Strategy* sides[SIM_MAX_PLAYERS];
+    double points = 0.0;
+    for (int g = 0; g < games; g++) {
+        int aIsTeam1 = (g % 2) == 0;
+        for (int i = 0; i < gRoster.count; i++) {
+            int team1 = gRoster.team[i] != 2;
+            sides[i] = (team1 == aIsTeam1) ? a : b;
+        }
+        SimResult r;
+        simRun(sim, &gRules, sides, seed + (unsigned)(g / 2) * 7919u, &r);
+        int mine = aIsTeam1 ? r.score1 : r.score2;
+        int theirs = aIsTeam1 ? r.score2 : r.score1;
+        points += mine > theirs ? 1.0 : (mine == theirs ? 0.5 : 0.0);
+    }
+    return points;
+}
+
+// Points per game against the baseline and every hall-of-fame strategy
+static double evaluate(SimGame* sim, const Strategy* s, unsigned seed) {
+    double points = playMatch(sim, s, &gBaseline, seed, gGames);
+    for (int h = 0; h < gHallCount; h++) {
+        points += playMatch(sim, s, &gHall[h], seed, gGames);
+    }
+    return points / (gGames * (1 + gHallCount));
+}
+
+static void* evaluateWorker(void* arg) {
+    (void)arg;
+    SimGame* sim = malloc(sizeof(SimGame));
+    if (!sim || simInit(sim, &gRoster) == -1) {
+        perror("simInit");
+        exit(EXIT_FAILURE);
+    }
+    for (;;) {
+        int c = __atomic_fetch_add(&gNextCandidate, 1, __ATOMIC_RELAXED);
+        if (c >= gCandidateCount) break;
+        gCandidates[c].fitness = evaluate(sim, &gCandidates[c].strategy, gGenSeed);
+    }
+    simFree(sim);
+    free(sim);
+    return NULL;
+}
+
+// ----------------------------
+// evaluateAll
+// Score every candidate on the same seeds across gThreads threads.
+// ----------------------------
+static void evaluateAll(Candidate* cands, int count, unsigned seed) {
+    gCandidates     = cands;
+    gCandidateCount = count;
+    gNextCandidate  = 0;
+    gGenSeed        = seed;
+    pthread_t threads[256];
+    int n = gThreads < 256 ? gThreads : 256;
+    for (int t = 0; t < n; t++) {
+        if (pthread_create(&threads[t], NULL, evaluateWorker, NULL) != 0) {
+            perror("pthread_create");
+            exit(EXIT_FAILURE);
+        }
+    }
+    for (int t = 0; t < n; t++) pthread_join(threads[t], NULL);
+}
+
+static int compareFitness(const void* a, const void* b) {
+    double x = ((const Candidate*)a)->fitness, y = ((const Candidate*)b)->fitness;
+    return (x < y) - (x > y);   // best first
+}
+
+static void randomStrategy(Strategy* s) {
+    for (int k = 0; k < STRATEGY_WEIGHTS; k++) {
+        *weightAt(s, k) = gWeightLo[k] + uniform() * (gWeightHi[k] - gWeightLo[k]);
+    }
+}
+
+static const Candidate* tournament(const Candidate* pop, int count) {
+    const Candidate* best = &pop[(int)(uniform() * count) % count];
+    for (int k = 1; k < TOURNAMENT; k++) {
+        const Candidate* c = &pop[(int)(uniform() * count) % count];
+        if (c->fitness > best->fitness) best = c;
+    }
+    return best;
+}
+
+// ----------------------------
+// breed
+// Child of two tournament winners: each weight from either parent,
+// then a Gaussian step, clamped to the search range.
+// ----------------------------
+static void breed(const Candidate* pop, int count, Strategy* child) {
+    const Strategy* a = &tournament(pop, count)->strategy;
+    const Strategy* b = &tournament(pop, count)->strategy;
+    for (int k = 0; k < STRATEGY_WEIGHTS; k++) {
+        double range = gWeightHi[k] - gWeightLo[k];
+        double w = *weightAt((Strategy*)(uniform() < 0.5 ? a : b), k);
+        w += gaussian() * gSigma * range;
+        if (w < gWeightLo[k]) w = gWeightLo[k];
+        if (w > gWeightHi[k]) w = gWeightHi[k];
+        *weightAt(child, k) = w;
+    }
+}
+
+static void usage(const char* prog) {
+    fprintf(stderr,
+            "Usage: %s [options] <roster file>\n"
+            "  --population=N (48)  --generations=N (30)  --games=N (64 per opponent)\n"
+            "  --threads=N (cores)  --elite=N (4)  --sigma=X (0.15)  --seed=N (1)\n"
+            "  --config=FILE (config.txt)  game rules as the referee reads them; these override it:\n"
+            "  --threshold=N  --max-rounds=N  --consecutive=N  --round-ticks=N\n"
+            "  --depletion-min=N  --depletion-max=N\n"
+            "  --opponent=FILE (default strategy)  --out=FILE (best.strategy)\n"
+            "  --evaluate=FILE   only score FILE against the opponent\n",
+            prog);
+    exit(EXIT_FAILURE);
+}
+
+int main(int argc, char* argv[]) {
+    const char* rosterFile = NULL;
+    const char* opponentFile = NULL;
+    const char* configFile = "config.txt";
+    for (int i = 1; i < argc; i++) {
+        if (strncmp(argv[i], "--config=", 9) == 0) configFile = argv[i] + 9;
+    }
+    GameConfig cfg;
+    initGameConfig(&cfg);
+    if (loadGameConfig(&cfg, configFile) == -1) exit(EXIT_FAILURE);
+    simRulesFromConfig(&gRules, &cfg);
+
+    for (int i = 1; i < argc; i++) {
+        const char* a = argv[i];
+        const char* v = strchr(a, '=');
+        v = v ? v + 1 : "";
+        if      (strncmp(a, "--population=", 13) == 0)    gPopulation = atoi(v);
+        else if (strncmp(a, "--generations=", 14) == 0)   gGenerations = atoi(v);
+        else if (strncmp(a, "--games=", 8) == 0)          gGames = atoi(v);
+        else if (strncmp(a, "--threads=", 10) == 0)       gThreads = atoi(v);
+        else if (strncmp(a, "--elite=", 8) == 0)          gElite = atoi(v);
+        else if (strncmp(a, "--sigma=", 8) == 0)          gSigma = atof(v);
+        else if (strncmp(a, "--seed=", 7) == 0)           gSeed = (unsigned)strtoul(v, NULL, 10);
+        else if (strncmp(a, "--threshold=", 12) == 0)     gRules.threshold = atoi(v);
+        else if (strncmp(a, "--max-rounds=", 13) == 0)    gRules.maxRounds = atoi(v);
+        else if (strncmp(a, "--consecutive=", 14) == 0)   gRules.consecutive = atoi(v);
+        else if (strncmp(a, "--round-ticks=", 14) == 0)   gRules.roundTicks = atoi(v);
+        else if (strncmp(a, "--depletion-min=", 16) == 0) gRules.depletionMin = atoi(v);
+        else if (strncmp(a, "--depletion-max=", 16) == 0) gRules.depletionMax = atoi(v);
+        else if (strncmp(a, "--opponent=", 11) == 0)      opponentFile = v;
+        else if (strncmp(a, "--out=", 6) == 0)            gOutFile = v;
+        else if (strncmp(a, "--evaluate=", 11) == 0)      gEvalFile = v;
+        else if (strncmp(a, "--config=", 9) == 0)         continue;   // loaded above
+        else if (a[0] != '-')                             rosterFile = a;
+        else                                              usage(argv[0]);
+    }
+    if (!rosterFile || gPopulation < 2 || gGenerations < 1 || gGames < 2 || gSeed == 0 ||
+        gRules.roundTicks < 1 || gRules.depletionMin < 0 || gRules.depletionMax < gRules.depletionMin) {
+        usage(argv[0]);
+    }
+    if (gElite < 0 || gElite > gPopulation) gElite = gPopulation;
+    if (gThreads <= 0) gThreads = (int)sysconf(_SC_NPROCESSORS_ONLN);
+    if (gThreads <= 0) gThreads = 1;
+    gRng ^= (uint64_t)gSeed * 0x2545f4914f6cdd1dULL;
+
+    if (readSimRoster(rosterFile, &gRoster) == -1) {
+        fprintf(stderr, "No players in roster %s\n", rosterFile);
+        exit(EXIT_FAILURE);
+    }
+    strategyDefault(&gBaseline);
+    if (opponentFile && loadStrategy(opponentFile, &gBaseline) == -1) exit(EXIT_FAILURE);
+
+    // Validation seeds are never used for selection
+    unsigned validationSeed = gSeed * 1000003u + 0x5bd1e995u;
+
+    if (gEvalFile) {
+        Candidate c;
+        if (loadStrategy(gEvalFile, &c.strategy) == -1) exit(EXIT_FAILURE);
+        long long start = nowNs();
+        evaluateAll(&c, 1, validationSeed);
+        double secs = (nowNs() - start) / 1e9;
+        printf("[Evolve] %s vs %s: %.3f points/game over %d games (%.0f games/s)\n",
+               gEvalFile, opponentFile ? opponentFile : "default", c.fitness, gGames, gGames / secs);
+        return 0;
+    }
+
+    Candidate* pop  = calloc(gPopulation, sizeof(Candidate));
+    Candidate* next = calloc(gPopulation, sizeof(Candidate));
+    if (!pop || !next) {
+        perror("calloc");
+        exit(EXIT_FAILURE);
+    }
+    // Seed the population with the baseline and the default strategy
+    pop[0].strategy = gBaseline;
+    strategyDefault(&pop[1].strategy);
+    for (int c = 2; c < gPopulation; c++) randomStrategy(&pop[c].strategy);
+
+    printf("[Evolve] %d players, population %d, %d generations, %d games per opponent, %d threads\n",
+           gRoster.count, gPopulation, gGenerations, gGames, gThreads);
+
+    long long totalGames = 0, startNs = nowNs();
+    Strategy best = pop[0].strategy;
+    for (int gen = 1; gen <= gGenerations; gen++) {
+        long long genStart = nowNs();
+        evaluateAll(pop, gPopulation, gSeed + (unsigned)gen * 104729u);
+        qsort(pop, gPopulation, sizeof(Candidate), compareFitness);
+        long long games = (long long)gPopulation * gGames * (1 + gHallCount);
+        totalGames += games;
+
+        double mean = 0.0;
+        for (int c = 0; c < gPopulation; c++) mean += pop[c].fitness;
+        mean /= gPopulation;
+        char weights[160];
+        formatStrategy(&pop[0].strategy, weights, sizeof(weights));
+        double secs = (nowNs() - genStart) / 1e9;
+        printf("[Evolve] gen %3d: best %.3f mean %.3f  %s  (%lld games, %.0f games/s)\n",
+               gen, pop[0].fitness, mean, weights, games, games / secs);
+        best = pop[0].strategy;
+
+        // The generation's best joins the opponents (oldest replaced first)
+        gHall[(gen - 1) % MAX_HALL] = best;
+        if (gHallCount < MAX_HALL) gHallCount++;
+
+        for (int c = 0; c < gElite; c++) next[c] = pop[c];
+        for (int c = gElite; c < gPopulation; c++) breed(pop, gPopulation, &next[c].strategy);
+        Candidate* swap = pop;
+        pop  = next;
+        next = swap;
+    }
+    double totalSecs = (nowNs() - startNs) / 1e9;
+    printf("[Evolve] %lld games in %.2f s (%.0f games/s on %d threads)\n",
+           totalGames, totalSecs, totalGames / totalSecs, gThreads);
+
+    // Final score against the baseline alone, on seeds never selected on
+    gHallCount = 0;
+    Candidate final = { best, 0.0 };
+    evaluateAll(&final, 1, validationSeed);
+    printf("[Evolve] Best strategy vs %s on fresh seeds: %.3f points/game\n",
+           opponentFile ? opponentFile : "default", final.fitness);
+
+    char comment[512], weights[160];
+    formatStrategy(&best, weights, sizeof(weights));
+    snprintf(comment, sizeof(comment),
+             "Written by evolve (%s, seed %u, %d generations x %d candidates)\n"
+             "Rules: threshold %d, max rounds %d, consecutive %d, round ticks %d, depletion %d:%d\n"
+             "Score vs %s on fresh seeds: %.3f points/game",
+             rosterFile, gSeed, gGenerations, gPopulation,
+             gRules.threshold, gRules.maxRounds, gRules.consecutive, gRules.roundTicks,
+             gRules.depletionMin, gRules.depletionMax,
+             opponentFile ? opponentFile : "default", final.fitness);
+    if (saveStrategy(gOutFile, &best, comment) == -1) exit(EXIT_FAILURE);
+    printf("[Evolve] Wrote %s (%s)\n", gOutFile, weights);
+
+    free(pop);
+    free(next);
+    return 0;
+}
@@ -12,20 +12,13 @@
 */
 
 #include "game_logic.h"
-#include "parent.h"   // So we know about Player, gPlayers, NUM_PLAYERS
+#include "parent.h"   // So we know about gPlayers, NUM_PLAYERS
 #include <stdio.h>
 #include <stdlib.h>
 #include <time.h>
 #include <unistd.h>
 #include <math.h>
 
-// We assume 8 players (4 per team)
-#define NUM_PLAYERS 8
-
-// If gPlayers is declared in parent.c, we can reference it here:
-extern Player gPlayers[NUM_PLAYERS];
-// Declare the external statusMessage variable
-
 // ----------------------------
 // initGameLogic
 // ----------------------------
@@ -36,9 +29,9 @@ void initGameLogic(GameState* state) {
     state->consecutiveWinsTeam1 = 0;
     state->consecutiveWinsTeam2 = 0;
 
-    // Example defaults
-    state->winThreshold = 500;
-    state->maxRounds    = 5;
+    state->winThreshold        = DEFAULT_WIN_THRESHOLD;
+    state->maxRounds           = DEFAULT_MAX_ROUNDS;
+    state->consecutiveWinLimit = DEFAULT_CONSECUTIVE_WINS;
 
     state->currentTime  = 0;
     state->sumTeam1     = 0;
@@ -47,87 +40,21 @@ void initGameLogic(GameState* state) {
     printf("[Referee] Game logic initialized.\n");
 }
 
-// ----------------------------
-// gatherTeam
-// Collect the 4 players from a given team into a temporary array.
-// Returns how many found (should be 4).
-// ----------------------------
-static int gatherTeam(Player dest[4], int team) {
-    int count = 0;
-    for (int i = 0; i < NUM_PLAYERS; i++) {
-        if (gPlayers[i].team == team) {
-            dest[count++] = gPlayers[i];
-            if (count == 4) break;
-        }
-    }
-    return count; // hopefully 4
-}
-
-// ----------------------------
-// sortByEnergyAsc
-// Sort an array of 4 players by ascending energy
-// ----------------------------
-static void sortByEnergyAsc(Player arr[4]) {
-    for (int i = 0; i < 4; i++) {
-        for (int j = i+1; j < 4; j++) {
-            if (arr[j].energy < arr[i].energy) {
-                Player tmp = arr[i];
-                arr[i] = arr[j];
-                arr[j] = tmp;
-            }
-        }
-    }
-}
-
 // ----------------------------
 // reorderTeams
-// - gather 4 players for Team1 => sort => assign factor=1..4
-// - gather 4 players for Team2 => sort => assign factor=1..4
-// - write them back to gPlayers
+// - rank each team's players by energy => assign factor=1..4
+//   (lowest energy gets factor 1, highest gets factor 4)
 // ----------------------------
 void reorderTeams() {
-    Player t1[4], t2[4];
-
-    // Gather players for Team 1 and Team 2
-    gatherTeam(t1, 1);
-    gatherTeam(t2, 2);
-
-    // Sort each team's players by ascending energy
-    sortByEnergyAsc(t1);
-    sortByEnergyAsc(t2);
-
-    // Assign factors 1..4 (lowest energy gets factor 1, highest gets factor 4)
-    for (int i = 0; i < 4; i++) {
-        t1[i].positionFactor = i + 1; 
-        t2[i].positionFactor = i + 1;
-    }
+    assignFactors(&gPlayers);
 
     // Debug prints to verify reordering and factor assignment
-    for (int i = 0; i < 4; i++) {
-        printf("[Referee] Team1 - Player %d: energy=%.2f, assigned factor=%d\n",
-               t1[i].id, t1[i].energy, t1[i].positionFactor);
-    }
-    for (int i = 0; i < 4; i++) {
-        printf("[Referee] Team2 - Player %d: energy=%.2f, assigned factor=%d\n",
-               t2[i].id, t2[i].energy, t2[i].positionFactor);
-    }
-
-    // Map the new factors back to the global gPlayers array by matching IDs.
-    for (int i = 0; i < 4; i++) {
-        int id = t1[i].id;
-        for (int j = 0; j < NUM_PLAYERS; j++) {
-            if (gPlayers[j].id == id) {
-                gPlayers[j].positionFactor = t1[i].positionFactor;
-                break;
-            }
-        }
-    }
-    for (int i = 0; i < 4; i++) {
-        int id = t2[i].id;
-        for (int j = 0; j < NUM_PLAYERS; j++) {
-            if (gPlayers[j].id == id) {
-                gPlayers[j].positionFactor = t2[i].positionFactor;
-                break;
+    for (int team = 1; team <= 2; team++) {
+        for (int f = 1; f <= NUM_FACTORS; f++) {
+            for (int i = 0; i < gPlayers.count; i++) {
+                if (playerTeam(&gPlayers, i) != team || playerFactor(&gPlayers, i) != f) continue;
+                printf("[Referee] Team%d - Player %d: energy=%d, assigned factor=%d\n",
+                       team, gPlayers.id[i], gPlayers.energy[i], f);
             }
         }
     }
@@ -149,34 +76,17 @@ void startRound(GameState* state) {
 
 // ----------------------------
 // collectEnergies
-// We read raw values from each pipe, multiply by the player's factor
-// in the PARENT side, to truly reflect factor=1..4 advantage
+// reports[i] is the effective energy reported by gPlayers[i] this tick
+// (already multiplied by the factor in player.c), or -1 if the player
+// did not answer in time. Missing reports and fallen players add nothing.
 // ----------------------------
- // Collect energies from the child processes
- void collectEnergies(GameState* state, int pipeFDsTeam1[], int pipeFDsTeam2[]) {
-    int totalTeam1 = 0;
-    int totalTeam2 = 0;
-
-    for (int i = 0; i < 4; i++) {
-        int rawVal = 0;
-        if (read(pipeFDsTeam1[i], &rawVal, sizeof(rawVal)) > 0) {
-            gPlayers[i].energy = (double) rawVal;  // already multiplied in player.c
-            totalTeam1 += rawVal;
-        }
-    }
-
-    for (int i = 0; i < 4; i++) {
-        int rawVal = 0;
-        if (read(pipeFDsTeam2[i], &rawVal, sizeof(rawVal)) > 0) {
-            int idx = i + 4;
-            gPlayers[idx].energy = (double) rawVal;
-            totalTeam2 += rawVal;
-        }
-    }
+void collectEnergies(GameState* state, const int reports[]) {
+    int64_t totalTeam1, totalTeam2;
+    sumTeamEnergies(&gPlayers, reports, &totalTeam1, &totalTeam2);
 
-    state->sumTeam1 = totalTeam1;
-    state->sumTeam2 = totalTeam2;
-    printf("[Referee] Collected energies => T1=%d, T2=%d\n", totalTeam1, totalTeam2);
+    state->sumTeam1 = (int)totalTeam1;
+    state->sumTeam2 = (int)totalTeam2;
+    printf("[Referee] Collected energies => T1=%d, T2=%d\n", state->sumTeam1, state->sumTeam2);
 }
 // ----------------------------
 // checkRoundWinner
@@ -219,15 +129,16 @@ void endRound(GameState* state, int winningTeam) {
 
 // ----------------------------
 // isGameOver
-// stop if maxRounds reached or consecutive wins =2
+// stop if maxRounds reached or consecutive wins = consecutiveWinLimit
 // ----------------------------
 int isGameOver(GameState* state) {
     if (state->roundNumber >= state->maxRounds) {
         printf("[Referee] Maximum rounds reached.\n");
         return 1;
     }
-    if (state->consecutiveWinsTeam1 >= 2 || state->consecutiveWinsTeam2 >= 2) {
-        printf("[Referee] A team has won 2 consecutive rounds.\n");
+    if (state->consecutiveWinsTeam1 >= state->consecutiveWinLimit ||
+        state->consecutiveWinsTeam2 >= state->consecutiveWinLimit) {
+        printf("[Referee] A team has won %d consecutive rounds.\n", state->consecutiveWinLimit);
         return 1;
     }
     return 0;
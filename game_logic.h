@@ -1,6 +1,14 @@
 #ifndef GAME_LOGIC_H
 #define GAME_LOGIC_H
 
+// Bump whenever round rules or player behaviour change, so cached
+// parameter-sweep results computed by an older engine are not reused.
+#define ENGINE_VERSION 2   // 2: strategy effort and fatigue, GET_READY round payload
+
+// Built-in rules, used when config.txt leaves a rule at 0
+#define DEFAULT_WIN_THRESHOLD    500
+#define DEFAULT_MAX_ROUNDS       5
+#define DEFAULT_CONSECUTIVE_WINS 2
 
 
 // ============================
@@ -16,6 +24,7 @@ typedef struct {
     int consecutiveWinsTeam2;    // Consecutive rounds won by Team 2
     int winThreshold;            // Effort threshold for winning a round
     int maxRounds;               // Maximum number of rounds before game over
+    int consecutiveWinLimit;     // Consecutive round wins that end the game
     int currentTime;             // Total elapsed time (if needed)
     int sumTeam1;                // Sum of effective energies for Team 1 in the current round
     int sumTeam2;                // Sum of effective energies for Team 2 in the current round
@@ -28,7 +37,7 @@ typedef struct {
 void initGameLogic(GameState* state);
 void startRound(GameState* state);
 void reorderTeams(); 
-void collectEnergies(GameState* state, int pipeFDsTeam1[], int pipeFDsTeam2[]);
+void collectEnergies(GameState* state, const int reports[]);
 int checkRoundWinner(GameState* state);
 void endRound(GameState* state, int winningTeam);
 int isGameOver(GameState* state);
@@ -0,0 +1,176 @@
+/*
+============================
+         game_sim.c
+   In-process game model for strategy evaluation:
+   - readSimRoster: same roster format as the referee
+   - simRulesFromConfig: the referee's rules from a GameConfig
+   - simStart / simTick: one referee tick at a time, with the referee's
+     rules and each player's depletion, effort and fatigue
+   - simRun: a whole game
+============================
+*/
+
+#define _GNU_SOURCE
+#include "game_sim.h"
+#include "game_logic.h"
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+
+// ----------------------------
+// readSimRoster
+// "<id> <team> <energy> [strategy]" lines; the strategy column is
+// ignored (the evaluator decides who plays what).
+// Returns 0 on success, -1 if the file cannot be read or is empty.
+// ----------------------------
+int readSimRoster(const char* filename, SimRoster* roster) {
+    FILE* fp = fopen(filename, "r");
+    if (!fp) {
+        perror(filename);
+        return -1;
+    }
+    roster->count = 0;
+    char line[256];
+    while (fgets(line, sizeof(line), fp) && roster->count < SIM_MAX_PLAYERS) {
+        if (line[0] == '#' || line[0] == '\n') continue;
+        int n = roster->count;
+        if (sscanf(line, "%d %d %lf", &roster->id[n], &roster->team[n], &roster->energy[n]) == 3) {
+            roster->energy[n] = (double)lround(roster->energy[n]);   // the referee keeps whole numbers
+            roster->count++;
+        }
+    }
+    fclose(fp);
+    return roster->count ? 0 : -1;
+}
+
+// ----------------------------
+// simRulesFromConfig
+// The rules the referee would play with cfg (config.txt plus any
+// overrides): rules left at 0 take game_logic's defaults, and the
+// round length comes from the tick and round timeout.
+// ----------------------------
+void simRulesFromConfig(SimRules* rules, const GameConfig* cfg) {
+    rules->threshold    = cfg->winThreshold    ? cfg->winThreshold    : DEFAULT_WIN_THRESHOLD;
+    rules->maxRounds    = cfg->maxRounds       ? cfg->maxRounds       : DEFAULT_MAX_ROUNDS;
+    rules->consecutive  = cfg->consecutiveWins ? cfg->consecutiveWins : DEFAULT_CONSECUTIVE_WINS;
+    rules->roundTicks   = configRoundTicks(cfg);
+    rules->depletionMin = cfg->depletionMin;
+    rules->depletionMax = cfg->depletionMax;
+}
+
+int simInit(SimGame* sim, const SimRoster* roster) {
+    memset(sim, 0, sizeof(*sim));
+    sim->roster = roster;
+    return playerTableInit(&sim->table, roster->count);
+}
+
+void simFree(SimGame* sim) {
+    playerTableFree(&sim->table);
+}
+
+// ----------------------------
+// simStart
+// Reset sim for a new game. `rules` and `strategies` (strategies[i] is
+// player i's, NULL = default) must stay valid until the game is over.
+// ----------------------------
+void simStart(SimGame* sim, const SimRules* rules, const Strategy* const strategies[], unsigned seed) {
+    const SimRoster* roster = sim->roster;
+    PlayerTable* t = &sim->table;
+
+    sim->rules      = rules;
+    sim->strategies = strategies;
+    strategyDefault(&sim->defaultStrategy);
+    for (int i = 0; i < roster->count; i++) {
+        t->id[i]     = roster->id[i];
+        t->flags[i]  = 1;   // factor 1, Team 1, not fallen (as playerTableInit)
+        setPlayerTeam(t, i, roster->team[i]);
+        t->energy[i] = (int32_t)roster->energy[i];
+        sim->energy[i] = roster->energy[i];
+        // player.c: srand(seed + id); rand() is random() with a 128-byte state
+        memset(&sim->rng[i], 0, sizeof(sim->rng[i]));
+        initstate_r(seed + (unsigned)roster->id[i], sim->rngState[i], SIM_RNG_STATE, &sim->rng[i]);
+    }
+    sim->round = sim->roundTick = sim->inProgress = sim->ticks = 0;
+    sim->score1 = sim->score2 = sim->streak1 = sim->streak2 = 0;
+    sim->sum1 = sim->sum2 = 0;
+}
+
+// ----------------------------
+// simTick
+// One refereeTick(): the game-over check runs first, a round starts
+// with START_PULLING depletion and new factors, then every player
+// reports once. Returns 0 (and does nothing) once the game is over.
+// ----------------------------
+int simTick(SimGame* sim) {
+    const SimRules* rules = sim->rules;
+    const SimRoster* roster = sim->roster;
+    PlayerTable* t = &sim->table;
+    int n = roster->count;
+
+    if (sim->round >= rules->maxRounds ||
+        sim->streak1 >= rules->consecutive || sim->streak2 >= rules->consecutive) return 0;
+
+    if (!sim->inProgress) {
+        sim->round++;
+        sim->roundTick  = 0;
+        sim->inProgress = 1;
+        int span = rules->depletionMax - rules->depletionMin + 1;
+        for (int i = 0; i < n; i++) {
+            int32_t r;
+            random_r(&sim->rng[i], &r);
+            sim->energy[i] -= rules->depletionMin + r % span;
+            if (sim->energy[i] < 0) sim->energy[i] = 0;
+        }
+        assignFactors(t);
+    }
+
+    sim->ticks++;
+    StrategyContext ctx;
+    ctx.round     = sim->round;
+    ctx.maxRounds = rules->maxRounds;
+    for (int i = 0; i < n; i++) {
+        const Strategy* s = sim->strategies[i] ? sim->strategies[i] : &sim->defaultStrategy;
+        int team = roster->team[i];
+        ctx.energy       = sim->energy[i];
+        ctx.rosterEnergy = roster->energy[i];
+        ctx.factor       = playerFactor(t, i);
+        ctx.ownScore     = team == 2 ? sim->score2 : sim->score1;
+        ctx.otherScore   = team == 2 ? sim->score1 : sim->score2;
+        double effort = strategyEffort(s, &ctx);
+        sim->reports[i] = (int32_t)(sim->energy[i] * ctx.factor * effort);
+        sim->energy[i]  = strategyFatigue(sim->energy[i], roster->energy[i], effort);
+    }
+    sumTeamEnergies(t, sim->reports, &sim->sum1, &sim->sum2);
+
+    int winner = sim->sum1 >= rules->threshold ? 1 : (sim->sum2 >= rules->threshold ? 2 : 0);
+    if (winner == 1) {
+        sim->score1++;
+        sim->streak1++;
+        sim->streak2 = 0;
+    } else if (winner == 2) {
+        sim->score2++;
+        sim->streak2++;
+        sim->streak1 = 0;
+    }
+    if (winner || ++sim->roundTick >= rules->roundTicks) sim->inProgress = 0;
+    return 1;
+}
+
+void simResult(const SimGame* sim, SimResult* result) {
+    result->score1 = sim->score1;
+    result->score2 = sim->score2;
+    result->rounds = sim->round;
+    result->ticks  = sim->ticks;
+}
+
+// ----------------------------
+// simRun
+// A whole game at once (the evaluator's entry point).
+// ----------------------------
+void simRun(SimGame* sim, const SimRules* rules, const Strategy* const strategies[],
+            unsigned seed, SimResult* result) {
+    simStart(sim, rules, strategies, seed);
+    while (simTick(sim)) {
+    }
+    simResult(sim, result);
+}
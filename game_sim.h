@@ -0,0 +1,88 @@
+#ifndef GAME_SIM_H
+#define GAME_SIM_H
+
+/*
+  game_sim.h
+  ----------
+  In-process model of a whole game, for evaluating player strategies
+  thousands of times a second without processes, signals or clocks.
+
+  It follows the referee and the players step by step: the referee's
+  round/tick/winner rules (game_logic.c), its factor assignment
+  (assignFactors), and each player's depletion and strategy effort.
+  Each player draws from its own glibc random_r() stream seeded like
+  player.c's srand(seed + id), so with the default strategy and no
+  crashes or late reports a simulated game matches a headless game
+  run over the socket transport with the same --seed. (With signals,
+  pending START_PULLING / GET_READY / REPORT_ENERGY signals are not
+  always handled in the order sent, so those games vary run to run.)
+
+  simRun plays a whole game; simStart / simTick step one referee tick
+  at a time for viewers (arena.c). One SimGame per thread; it owns all
+  of its scratch memory.
+*/
+
+#include "config.h"
+#include "player_table.h"
+#include "strategy.h"
+#include <stdlib.h>
+
+#define SIM_MAX_PLAYERS 64
+#define SIM_RNG_STATE   128   // bytes of random_r state (glibc's srand default)
+
+// ============================
+// Rules, roster and results
+// ============================
+typedef struct {
+    int threshold;        // team sum that wins a round
+    int maxRounds;
+    int consecutive;      // consecutive round wins that end the game
+    int roundTicks;       // ticks before a round ends with no winner
+    int depletionMin;     // energy lost per START_PULLING: min..max
+    int depletionMax;
+} SimRules;
+
+typedef struct {
+    int    count;
+    int    id[SIM_MAX_PLAYERS];
+    int    team[SIM_MAX_PLAYERS];     // 1 or 2
+    double energy[SIM_MAX_PLAYERS];   // roster energy
+} SimRoster;
+
+typedef struct {
+    int score1, score2;
+    int rounds;
+    int ticks;
+} SimResult;
+
+typedef struct {
+    const SimRoster* roster;
+    PlayerTable      table;                      // the referee's view
+    double           energy[SIM_MAX_PLAYERS];    // each player's own energy
+    struct random_data rng[SIM_MAX_PLAYERS];
+    char             rngState[SIM_MAX_PLAYERS][SIM_RNG_STATE];
+
+    // Game in progress (simStart)
+    const SimRules*        rules;
+    const Strategy* const* strategies;           // NULL entries = default strategy
+    Strategy         defaultStrategy;
+    int              round, roundTick, inProgress, ticks;
+    int              score1, score2, streak1, streak2;
+    int64_t          sum1, sum2;                 // team sums of the last tick
+    int32_t          reports[SIM_MAX_PLAYERS];
+} SimGame;
+
+// ============================
+// Function Prototypes
+// ============================
+int  readSimRoster(const char* filename, SimRoster* roster);
+void simRulesFromConfig(SimRules* rules, const GameConfig* cfg);
+int  simInit(SimGame* sim, const SimRoster* roster);
+void simFree(SimGame* sim);
+void simRun(SimGame* sim, const SimRules* rules, const Strategy* const strategies[],
+            unsigned seed, SimResult* result);
+void simStart(SimGame* sim, const SimRules* rules, const Strategy* const strategies[], unsigned seed);
+int  simTick(SimGame* sim);
+void simResult(const SimGame* sim, SimResult* result);
+
+#endif // GAME_SIM_H
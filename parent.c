@@ -6,10 +6,12 @@
    - Reads configuration file for players
    - Forks 8 child processes (players) & sets up pipes for raw energy reporting
    - Uses game_logic to do startRound, collectEnergies, checkRoundWinner, etc.
-   - Runs OpenGL to visualize the rope & players
+   - Drives rounds from a timerfd tick on a dedicated referee thread
+   - Runs OpenGL to visualize the rope & players (or runs headless)
 ============================
 */
 
+#define _GNU_SOURCE
 #include <GL/glut.h>
 #include <stdio.h>
 #include <stdlib.h>
@@ -17,24 +19,38 @@
 #include <math.h>
 #include <unistd.h>     // fork, pipe
 #include <sys/types.h>
+#include <errno.h>
 #include <signal.h>
+#include <pthread.h>
+#include <time.h>
+#include <sys/epoll.h>
+#include <sys/resource.h>
 
 #include "parent.h"
 #include "game_logic.h"
-// #include "config.h" // only if you want advanced config logic
-
-#define NUM_PLAYERS 8 // 4 for Team1, 4 for Team2
+#include "config.h"
+#include "tick_clock.h"
+#include "player_procs.h"
+#include "results_store.h"
+#include "sched_tune.h"
+#include "trace.h"
+#include "shared_view.h"
+#include "checkpoint.h"
 
 // Global arrays for players & rope
-Player    gPlayers[NUM_PLAYERS];
+PlayerTable   gPlayers;                // hot/cold split round-logic storage
+PlayerSprite* gPlayerSprites = NULL;   // screen positions, window only
 Rope      gRope;
 GameState gState;   // Tracks round #, scores, sums, etc.
+GameConfig gConfig; // Tick interval, round timeout, time compression, ...
+
+// Guards gPlayers, gState and the rope targets, which are written by the
+// referee thread (round logic) and read by the GLUT thread (rendering).
+pthread_mutex_t gStateLock = PTHREAD_MUTEX_INITIALIZER;
 
-// We'll store child PIDs and the read ends of the pipes.
-static int pipeEnergy[NUM_PLAYERS][2];  // child -> parent
-static int pipeFactor[NUM_PLAYERS][2];  // parent -> child
-static pid_t childPIDs[NUM_PLAYERS];
-static int   pipeReadFDs[NUM_PLAYERS]; // parent reads from these
+static TickClock gTickClock;
+static int       gRoundTicks = 10;  // ticks before a round ends with no winner
+static int       gEpollFD    = -1;  // tick clock + player pidfds/pipes
 
 // For rope shift in updateScene()
 float ropeShift = 0.0f;
@@ -43,216 +59,712 @@ float energyDiff; // Global declaration
 
 
 // forward declarations
-static void spawnPlayers();
-static void timerRoundLogic(int val);
-void idle() {
-    static int lastTime = 0;
-    int currentTime = glutGet(GLUT_ELAPSED_TIME);
-    
-    // Only update if enough time has passed (for smooth animation)
-    if (currentTime - lastTime > 16) { // ~60fps
-        updateScene();
-        lastTime = currentTime;
-    }
-    glutPostRedisplay();
+static void* refereeLoop(void* arg);
+static void initResultsIds(void);
+static void writeTrace(void);
+static void publishGameView(int over);
+static void publishRopeView(void);
+static int  resumeGame(const char* path);
+static void resumeRope(void);
+static void saveRoundCheckpoint(void);
+static void printCheckpointStats(void);
+
+// Render on demand ------------------------------------------------
+#define FRAME_MS  16   // ~60 fps rope steps and dirty checks
+
+// Guarded by gStateLock
+static unsigned gSceneDirty = SCENE_ROPE | SCENE_PLAYERS | SCENE_ROUND;
+
+// Render thread statistics (counters read by the referee thread at game over)
+static pthread_t          gRenderThread;
+static long long          gRenderStartNs = 0;
+static unsigned long long gFramesDrawn   = 0;
+static unsigned long long gIdleFrames    = 0;
+
+// markSceneDirty
+// Caller holds gStateLock.
+void markSceneDirty(unsigned flags)
+{
+    gSceneDirty |= flags;
+}
+
+// frameTimer
+// Once per frame period from GLUT's event loop: step the rope, and
+// redraw only if something visible changed. Between timers GLUT sleeps
+// in its own event wait, so input, reshape and close are handled at
+// once and a change from the referee is drawn within one frame period.
+static void frameTimer(int value)
+{
+    (void)value;
+    glutTimerFunc(FRAME_MS, frameTimer, 0);
+    updateScene();
+
+    pthread_mutex_lock(&gStateLock);
+    unsigned dirty = gSceneDirty;
+    pthread_mutex_unlock(&gStateLock);
+    if (dirty) {
+        glutPostRedisplay();
+    } else {
+        __atomic_fetch_add(&gIdleFrames, 1, __ATOMIC_RELAXED);
+    }
 }
 float ropeTargetShift = 0.0f;
 float ropeVelocity = 0.0f;
 
+// printRenderStats
+// Frames drawn and the render thread's CPU share since the window opened.
+void printRenderStats(void)
+{
+    if (gRenderStartNs == 0) return;
+    unsigned long long frames = __atomic_load_n(&gFramesDrawn, __ATOMIC_RELAXED);
+    unsigned long long idle   = __atomic_load_n(&gIdleFrames, __ATOMIC_RELAXED);
+    double wallS = (monotonicNs() - gRenderStartNs) / 1e9;
+    clockid_t cid;
+    struct timespec cpu = { 0, 0 };
+    if (pthread_getcpuclockid(gRenderThread, &cid) == 0) clock_gettime(cid, &cpu);
+    double renderCpuS = cpu.tv_sec + cpu.tv_nsec / 1e9;
+    struct rusage ru;
+    getrusage(RUSAGE_SELF, &ru);
+    double processCpuS = ru.ru_utime.tv_sec + ru.ru_utime.tv_usec / 1e6 +
+                         ru.ru_stime.tv_sec + ru.ru_stime.tv_usec / 1e6;
+    printf("[Referee] Render: %llu frames in %.1f s (%.1f fps), %llu idle frames, "
+           "render thread CPU %.2f s (%.1f%%), process CPU %.2f s (%.1f%%)\n",
+           frames, wallS, frames / wallS, idle,
+           renderCpuS, 100.0 * renderCpuS / wallS, processCpuS, 100.0 * processCpuS / wallS);
+}
+
 
 // main ---------------------------------------------------------
 int main(int argc, char** argv)
 {
-    // (1) Read configuration for players (IDs, teams, initial energies)
-    const char* configFile = (argc > 1) ? argv[1] : "PlayersConfiguration.txt";
-    readConfigFile(configFile, gPlayers, NUM_PLAYERS);
+    // (1) Runtime settings: defaults -> config.txt -> command line
+    initGameConfig(&gConfig);
+    if (loadGameConfig(&gConfig, "config.txt") == -1 ||
+        parseGameArgs(&gConfig, argc, argv) == -1) {
+        exit(EXIT_FAILURE);
+    }
+    gRoundTicks = configRoundTicks(&gConfig);
 
-    // (2) Initialize game logic (roundNumber=0, threshold=500, etc.)
+    // (2) Read configuration for players (IDs, teams, initial energies)
+    if (playerTableInit(&gPlayers, NUM_PLAYERS) == -1) {
+        exit(EXIT_FAILURE);
+    }
+    readConfigFile(gConfig.playersFile, &gPlayers);
+    printPlayerFootprint(&gPlayers, !gConfig.headless);
+
+    // (3) Initialize game logic (roundNumber=0, threshold=500, etc.)
     initGameLogic(&gState);
+    if (gConfig.winThreshold)    gState.winThreshold        = gConfig.winThreshold;
+    if (gConfig.maxRounds)       gState.maxRounds           = gConfig.maxRounds;
+    if (gConfig.consecutiveWins) gState.consecutiveWinLimit = gConfig.consecutiveWins;
+
+    // Pick up a checkpointed game: state, round phase, players' own state
+    // (bare --resume reads the checkpoint file this run will write)
+    if (gConfig.resumeFile) {
+        const char* path = strcmp(gConfig.resumeFile, "1") == 0 ? gConfig.checkpointFile : gConfig.resumeFile;
+        if (!path || resumeGame(path) == -1) {
+            fprintf(stderr, "[Referee] Cannot resume%s\n", path ? "" : ": no checkpoint file configured");
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    // (4) Fork child processes & create pipes; every child is watched
+    //     in the referee's epoll loop. A dead player must not kill us
+    //     through SIGPIPE on its factor pipe.
+    signal(SIGPIPE, SIG_IGN);
+    gEpollFD = epoll_create1(EPOLL_CLOEXEC);
+    if (gEpollFD == -1) {
+        perror("epoll_create1");
+        exit(EXIT_FAILURE);
+    }
+    saveDefaultAffinity();
+    if (gConfig.traceFile) {
+        // Registered before stopPlayers so it runs after the players
+        // have exited and dumped their buffers.
+        traceOpen(NULL, -1, 0);
+        atexit(writeTrace);
+    }
+    spawnPlayers(gEpollFD);
+    atexit(stopPlayers);
+
+    // Optional columnar results file (per-tick, per-round, per-game rows)
+    if (gConfig.resultsFile && openResultsStore(gConfig.resultsFile) == 0) {
+        initResultsIds();
+        atexit(closeResultsStore);
+    }
 
-    // (3) Fork child processes & create pipes
-    spawnPlayers();
+    // Optional read-only spectator view in shared memory
+    if (gConfig.viewName && openSharedView(gConfig.viewName) == 0) {
+        atexit(closeSharedView);
+    }
 
-    // (4) Initialize GLUT / OpenGL
+    // (5) Arm the tick clock: first tick after the warm-up, then one per tick interval
+    long long tickWallNs = configWallNs(&gConfig, gConfig.tickIntervalNs);
+    if (tickClockOpen(&gTickClock, tickWallNs, configWallNs(&gConfig, gConfig.warmupNs)) == -1) {
+        exit(EXIT_FAILURE);
+    }
+    printf("[Referee] Tick %.3f ms, %d ticks per round, compression x%g (%.3f ms wall per tick)\n",
+           gConfig.tickIntervalNs / 1e6, gRoundTicks, gConfig.timeCompression, tickWallNs / 1e6);
+
+    if (gConfig.headless) {
+        refereeLoop(NULL);
+        return 0;
+    }
+
+    // (6) Initialize GLUT / OpenGL
     glutInit(&argc, argv);
     glutInitDisplayMode(GLUT_DOUBLE | GLUT_RGB);
     glutInitWindowSize(800, 600);
     glutInitWindowPosition(100, 100);
     glutCreateWindow("Rope Pulling Game - Multi-Process");
     initOpenGL();
-    glutIdleFunc(idle);
-
-
-    // (5) Initialize player positions & rope
-    initPlayers(gPlayers, NUM_PLAYERS);
-    initRope(&gRope, 10, 350.0, 220.0, 300.0);
-    glutTimerFunc(1500, timerRoundLogic, 0);
+    glutTimerFunc(FRAME_MS, frameTimer, 0);
+
+    // (7) Initialize rope and the players' screen positions
+    initRope(&gRope, ROPE_NODES, ROPE_LENGTH, ROPE_START_X, SCENE_Y);
+    gRope.iterations = gConfig.ropeIterations;
+    gRope.tolerance  = gConfig.ropeTolerance;
+    gRope.sleepSpeed = gConfig.ropeSleepSpeed;
+    resumeRope();
+    gPlayerSprites = calloc(gPlayers.count, sizeof(PlayerSprite));
+    if (!gPlayerSprites) {
+        perror("calloc player sprites");
+        exit(EXIT_FAILURE);
+    }
+    initPlayerSprites(&gPlayers, gPlayerSprites);
 
-    // (6) Set up GLUT callbacks
+    // (8) Set up GLUT callbacks
     glutDisplayFunc(display);
     glutReshapeFunc(reshape);
-    // We'll do round logic once per second
 
-    // (7) Enter main loop
+    // (9) Round logic runs on its own thread, paced by the tick clock
+    pthread_t refereeThread;
+    if (pthread_create(&refereeThread, NULL, refereeLoop, NULL) != 0) {
+        perror("pthread_create");
+        exit(EXIT_FAILURE);
+    }
+
+    // (10) Enter main loop (this thread only renders from here on)
+    pinThreadToCpus("Render thread", gConfig.renderCpus);
+    gRenderThread  = pthread_self();
+    gRenderStartNs = monotonicNs();
     glutMainLoop();
 
     freeRope(&gRope);
     return 0;
 }
 
-// spawnPlayers in parent.c  --------------------------------------------------
-static void spawnPlayers()
+// Results recording ----------------------------------------------
+static int32_t gGameId     = 0;  // random per run, shared by all rows of this game
+static int32_t gRosterHash = 0;  // identifies the roster (IDs, teams, energies)
+static int32_t gTotalTicks = 0;
+static int32_t gPeakTeam1  = 0;  // highest team sums seen in the current round
+static int32_t gPeakTeam2  = 0;
+
+// initResultsIds
+// A resumed game keeps the IDs from its checkpoint.
+static void initResultsIds(void)
+{
+    if (gGameId) return;
+    uint64_t h = FNV1A64_INIT;
+    for (int i = 0; i < NUM_PLAYERS; i++) {
+        int32_t key[3] = { gPlayers.id[i], playerTeam(&gPlayers, i), gPlayers.energy[i] };
+        h = fnv1a64(key, sizeof(key), h);
+    }
+    gRosterHash = (int32_t)(h & 0x7fffffff);
+
+    long long seed[2] = { monotonicNs(), getpid() };
+    gGameId = (int32_t)(fnv1a64(seed, sizeof(seed), FNV1A64_INIT) & 0x7fffffff);
+}
+
+// recordTick
+// Team sum trajectory; also tracks the round's peak sums.
+static void recordTick(int tickInRound)
 {
-    for (int i=0; i<NUM_PLAYERS; i++) {
-        // pipe for energy (child -> parent)
-        int fdsEnergy[2];
-        if (pipe(fdsEnergy)==-1) {
-            perror("pipe energy");
-            exit(1);
-        }
+    if (gState.sumTeam1 > gPeakTeam1) gPeakTeam1 = gState.sumTeam1;
+    if (gState.sumTeam2 > gPeakTeam2) gPeakTeam2 = gState.sumTeam2;
+    gTotalTicks++;
+    if (!resultsStoreOpen()) return;
+
+    int32_t row[TICK_COLS];
+    row[TICK_GAME]  = gGameId;
+    row[TICK_ROUND] = gState.roundNumber;
+    row[TICK_TICK]  = tickInRound;
+    row[TICK_SUM1]  = gState.sumTeam1;
+    row[TICK_SUM2]  = gState.sumTeam2;
+    resultsAppend(TABLE_TICKS, row);
+}
 
-        // pipe for factor (parent -> child)
-        int fdsFactor[2];
-        if (pipe(fdsFactor)==-1) {
-            perror("pipe factor");
-            exit(1);
+// recordRound
+// Called just before endRound() resets the round sums.
+static void recordRound(int winner, int ticks)
+{
+    if (resultsStoreOpen()) {
+        int32_t factors = 0;
+        for (int i = 0; i < NUM_PLAYERS; i++) {
+            factors |= (playerFactor(&gPlayers, i) & 0xf) << (4 * i);
         }
+        int32_t row[ROUND_COLS];
+        row[ROUND_GAME]     = gGameId;
+        row[ROUND_ROSTER]   = gRosterHash;
+        row[ROUND_ROUND]    = gState.roundNumber;
+        row[ROUND_WINNER]   = winner;
+        row[ROUND_TICKS]    = ticks;
+        row[ROUND_HIT_TICK] = winner ? ticks : -1;
+        row[ROUND_SUM1]     = gState.sumTeam1;
+        row[ROUND_SUM2]     = gState.sumTeam2;
+        row[ROUND_PEAK1]    = gPeakTeam1;
+        row[ROUND_PEAK2]    = gPeakTeam2;
+        row[ROUND_FACTORS]  = factors;
+        resultsAppend(TABLE_ROUNDS, row);
+    }
+    gPeakTeam1 = gPeakTeam2 = 0;
+}
 
-        pid_t pid = fork();
-        if (pid<0) {
-            perror("fork");
-            exit(1);
-        }
-        if (pid==0) {
-            // CHILD
-            // close parent's ends
-            close(fdsEnergy[0]);  // parent reads from here, child writes only
-            close(fdsFactor[1]);  // parent writes to here, child reads only
-
-            // Build arguments
-            char argID[10], argTeam[10], argEnergy[20];
-            char argWriteFD[10], argFactorReadFD[10];
-
-            sprintf(argID, "%d", gPlayers[i].id);
-            sprintf(argTeam, "%d", gPlayers[i].team);
-            sprintf(argEnergy, "%.1f", gPlayers[i].energy);
-
-            sprintf(argWriteFD, "%d", fdsEnergy[1]);
-            sprintf(argFactorReadFD, "%d", fdsFactor[0]);
-
-            // execl => 5 arguments in child: <playerID> <teamID> <initEnergy> <writeFD> <factorReadFD>
-            execl("./player", "player",
-                  argID, argTeam, argEnergy,
-                  argWriteFD, argFactorReadFD,
-                  (char*)NULL);
-
-            perror("execl failed");
-            exit(1);
-        }
-        else {
-            // PARENT
-            childPIDs[i] = pid;
-            
-            // keep track of these in global arrays if you want
-            pipeEnergy[i][0] = fdsEnergy[0]; // parent read end
-            pipeEnergy[i][1] = fdsEnergy[1]; // child write end
-            pipeFactor[i][0] = fdsFactor[0]; // child read end
-            pipeFactor[i][1] = fdsFactor[1]; // parent write end
-
-            // close the ends the parent doesn't use
-            close(fdsEnergy[1]);  // child writes
-            close(fdsFactor[0]);  // child reads
-        }
+// gameOver
+// Print the final score and record the game row.
+static void gameOver(void)
+{
+    printf("[Referee] Game Over => Final Score: Team1=%d, Team2=%d\n",
+           gState.scoreTeam1, gState.scoreTeam2);
+    publishGameView(1);
+    printCheckpointStats();
+    if (!gConfig.headless) {
+        printRopeStats(&gRope);
+        printRenderStats();
     }
+    if (!resultsStoreOpen()) return;
+
+    int32_t row[GAME_COLS];
+    row[GAME_GAME]   = gGameId;
+    row[GAME_ROSTER] = gRosterHash;
+    row[GAME_ROUNDS] = gState.roundNumber;
+    row[GAME_WINNER] = gState.scoreTeam1 > gState.scoreTeam2 ? 1 :
+                       gState.scoreTeam2 > gState.scoreTeam1 ? 2 : 0;
+    row[GAME_SCORE1] = gState.scoreTeam1;
+    row[GAME_SCORE2] = gState.scoreTeam2;
+    row[GAME_TICKS]  = gTotalTicks;
+    resultsAppend(TABLE_GAMES, row);
+    flushResultsStore();
+}
+
+
+// writeTrace
+// atexit hook: merge the referee and player trace buffers.
+static void writeTrace(void)
+{
+    traceWriteJson(gConfig.traceFile);
 }
 
 
 // Round logic ---------------------------------------------------
 static int roundInProgress = 0;
-static int secondCount     = 0;
+static int roundTickCount  = 0;  // ticks elapsed in the current round
+static uint32_t gTickSeq   = 0;  // sequence number of the current tick, echoed in reports
+
+// Scene state as of the last markSceneChanges(), guarded by gStateLock
+static int32_t gShownEnergy[NUM_PLAYERS];
+static uint8_t gShownFlags[NUM_PLAYERS];
+static int32_t gShownRound[6];
+
+// markSceneChanges
+// Set SCENE_PLAYERS / SCENE_ROUND only for what differs from the last
+// call: player energy, factor or fallen state; round number and phase,
+// team sums and scores. Caller holds gStateLock.
+static void markSceneChanges(void)
+{
+    unsigned flags = 0;
+    if (memcmp(gShownEnergy, gPlayers.energy, sizeof(gShownEnergy)) != 0 ||
+        memcmp(gShownFlags, gPlayers.flags, sizeof(gShownFlags)) != 0) {
+        memcpy(gShownEnergy, gPlayers.energy, sizeof(gShownEnergy));
+        memcpy(gShownFlags, gPlayers.flags, sizeof(gShownFlags));
+        flags |= SCENE_PLAYERS;
+    }
+    int32_t round[6] = { gState.roundNumber, roundInProgress, gState.sumTeam1, gState.sumTeam2,
+                         gState.scoreTeam1, gState.scoreTeam2 };
+    if (memcmp(gShownRound, round, sizeof(round)) != 0) {
+        memcpy(gShownRound, round, sizeof(round));
+        flags |= SCENE_ROUND;
+    }
+    if (flags) markSceneDirty(flags);
+}
 
-static void timerRoundLogic(int val)
+// publishGameView
+// Seqlock-publish the round state and players for spectators.
+// Referee thread only (the single writer of the game section).
+static void publishGameView(int over)
 {
-    
-    
-    if (isGameOver(&gState)) {
-        printf("[Referee] Game Over => Final Score: Team1=%d, Team2=%d\n",
-               gState.scoreTeam1, gState.scoreTeam2);
-        return;
+    SharedView* view = sharedView();
+    if (!view) return;
+
+    viewWriteBegin(&view->gameSeq);
+    ViewGame* g = &view->game;
+    g->publishedNs          = monotonicNs();
+    g->tickSeq              = gTickSeq;
+    g->gameOver             = over;
+    g->roundNumber          = gState.roundNumber;
+    g->roundInProgress      = roundInProgress;
+    g->roundTick            = roundTickCount;
+    g->roundTicks           = gRoundTicks;
+    g->scoreTeam1           = gState.scoreTeam1;
+    g->scoreTeam2           = gState.scoreTeam2;
+    g->consecutiveWinsTeam1 = gState.consecutiveWinsTeam1;
+    g->consecutiveWinsTeam2 = gState.consecutiveWinsTeam2;
+    g->winThreshold         = gState.winThreshold;
+    g->maxRounds            = gState.maxRounds;
+    g->consecutiveWinLimit  = gState.consecutiveWinLimit;
+    g->sumTeam1             = gState.sumTeam1;
+    g->sumTeam2             = gState.sumTeam2;
+    g->playerCount          = gPlayers.count < VIEW_MAX_PLAYERS ? gPlayers.count : VIEW_MAX_PLAYERS;
+    for (int i = 0; i < g->playerCount; i++) {
+        g->id[i]     = gPlayers.id[i];
+        g->energy[i] = gPlayers.energy[i];
+        g->team[i]   = (uint8_t)playerTeam(&gPlayers, i);
+        g->factor[i] = (uint8_t)playerFactor(&gPlayers, i);
+        g->fallen[i] = (uint8_t)playerFallen(&gPlayers, i);
     }
+    viewWriteEnd(&view->gameSeq);
+}
+
+// publishRopeView
+// Render thread only (the single writer of the rope section).
+static void publishRopeView(void)
+{
+    SharedView* view = sharedView();
+    if (!view) return;
+
+    viewWriteBegin(&view->ropeSeq);
+    ViewRope* r = &view->rope;
+    r->publishedNs     = monotonicNs();
+    r->ropeShift       = ropeShift;
+    r->ropeTargetShift = ropeTargetShift;
+    r->nodeCount       = gRope.numNodes < VIEW_MAX_NODES ? gRope.numNodes : VIEW_MAX_NODES;
+    for (int i = 0; i < r->nodeCount; i++) {
+        r->x[i] = (float)gRope.nodes[i].location.x;
+        r->y[i] = (float)gRope.nodes[i].location.y;
+    }
+    viewWriteEnd(&view->ropeSeq);
+}
+
+// refereeTick
+// One tick of round logic. Returns 0 once the game is over.
+static int refereeTick(void)
+{
+    pthread_mutex_lock(&gStateLock);
+    int over = isGameOver(&gState);
+    pthread_mutex_unlock(&gStateLock);
+    if (over) {
+        gameOver();
+        return 0;
+    }
+
+    // Without pidfds, dead children are only noticed by polling
+    reapPlayers(gEpollFD);
 
     // Start a new round if none in progress
     if (!roundInProgress) {
+        pthread_mutex_lock(&gStateLock);
         gState.roundNumber++;
         printf("\n[Referee] --- Starting Round %d ---\n", gState.roundNumber);
-        secondCount = 0;
+        roundTickCount = 0;
         roundInProgress = 1;
+        markSceneChanges();
+        pthread_mutex_unlock(&gStateLock);
 
         // Signal START_PULLING to all players to deplete energy
-        for (int i = 0; i < NUM_PLAYERS; i++) {
-            kill(childPIDs[i], SIGUSR2);
-        }
+        signalPlayers(gEpollFD, SIGUSR2, (int)gTickSeq);
 
-        // Delay a little to let energy decrease (optional: add usleep)
-        usleep(10000); // 10 ms pause
+        // Delay a little to let energy decrease (10 ms of game time)
+        traceBegin(TR_SETTLE, 0);
+        usleep(configWallNs(&gConfig, gConfig.settleNs) / 1000);
+        traceEnd(TR_SETTLE);
 
+        pthread_mutex_lock(&gStateLock);
         // * Reorder players based on depleted energy *
+        traceBegin(TR_REORDER, 0);
         reorderTeams();
+        traceEnd(TR_REORDER);
 
         // Send updated position factors to each child
-        for (int i = 0; i < NUM_PLAYERS; i++) {
-            int factor = gPlayers[i].positionFactor;
-            if (write(pipeFactor[i][1], &factor, sizeof(factor)) == -1) {
-                perror("write factor pipe");
-            } else {
-                printf("[Referee] Wrote factor %d to child %d\n", factor, gPlayers[i].id);
-            }
-        }
+        traceBegin(TR_SEND_FACTORS, 0);
+        RoundInfo round = { (uint8_t)gState.roundNumber, (uint8_t)gState.maxRounds,
+                            (uint8_t)gState.scoreTeam1, (uint8_t)gState.scoreTeam2 };
+        sendFactors(gEpollFD, &round);
+        traceEnd(TR_SEND_FACTORS);
+        publishGameView(0);
+        markSceneChanges();
+        pthread_mutex_unlock(&gStateLock);
 
         // Signal GET_READY so each player reads its factor
-        for (int i = 0; i < NUM_PLAYERS; i++) {
-            kill(childPIDs[i], SIGUSR1);
-        }
+        signalPlayers(gEpollFD, SIGUSR1, (int)gTickSeq);
     }
 
-    // Each second, ask players to report energy
-    for (int i = 0; i < NUM_PLAYERS; i++) {
-        kill(childPIDs[i], SIGALRM);
+    // Each tick, ask players to report energy, then wait a bounded
+    // time for the answers (a stuck or dead player reports nothing)
+    int reports[NUM_PLAYERS];
+    gTickSeq++;
+    signalPlayers(gEpollFD, SIGALRM, (int)gTickSeq);
+    traceBegin(TR_GATHER, gTickSeq);
+    int missing = gatherReports(gEpollFD, reports, gTickSeq, gConfig.reportTimeoutNs);
+    traceEnd(TR_GATHER);
+    if (missing) {
+        printf("[Referee] %d player(s) did not report in time\n", missing);
     }
 
-    // Collect reported energies
-    int pipesTeam1[4], pipesTeam2[4];
-    for (int i = 0; i < 4; i++) {
-        pipesTeam1[i] = pipeEnergy[i][0];
-        pipesTeam2[i] = pipeEnergy[i + 4][0];
-    }
-    collectEnergies(&gState, pipesTeam1, pipesTeam2);
+    pthread_mutex_lock(&gStateLock);
+    traceBegin(TR_COLLECT, gTickSeq);
+    collectEnergies(&gState, reports);
     //shifts rope towards the winning team
     double diff = (double)gState.sumTeam2 - (double)gState.sumTeam1;
-    ropeShift = diff * 0.08;
+    ropeShift = diff * ROPE_SHIFT_PER_SUM;
     printf("sum1: %d, sum2: %d, ropeShift: %f\n", gState.sumTeam1, gState.sumTeam2, ropeShift);
 
+    recordTick(roundTickCount + 1);
+
     // Check for round winner
     int winner = checkRoundWinner(&gState);
     if (winner) {
+        recordRound(winner, roundTickCount + 1);
         endRound(&gState, winner);
         roundInProgress = 0;
-        if (isGameOver(&gState)) {
-            printf("[Referee] Game Over => Final Score: Team1=%d, Team2=%d\n",
-                   gState.scoreTeam1, gState.scoreTeam2);
-            return;
-        }
     } else {
-        secondCount++;
-        if (secondCount >= 10) {
+        roundTickCount++;
+        if (roundTickCount >= gRoundTicks) {
+            recordRound(0, roundTickCount);
             endRound(&gState, 0); // No winner
             roundInProgress = 0;
         }
     }
-    ropeTargetShift = diff * 0.08;  // Target offset from center
+    ropeTargetShift = diff * ROPE_SHIFT_PER_SUM;  // Target offset from center
+    over = winner && isGameOver(&gState);
+    publishGameView(0);
+    markSceneChanges();
+    traceEnd(TR_COLLECT);
+    pthread_mutex_unlock(&gStateLock);
+
+    if (!roundInProgress) saveRoundCheckpoint();
+
+    if (over) {
+        gameOver();
+        return 0;
+    }
+    return 1;
+}
+
+// Checkpoints ----------------------------------------------------
+static Checkpoint gCheckpoint;             // capture buffer (referee thread)
+static int        gCheckpointCount = 0;
+static long long  gCheckpointTotalNs = 0;  // capture + write
+static long long  gCheckpointMaxNs   = 0;
+
+// captureCheckpoint
+// Copy the game, the players' last reported state and the rope into
+// gCheckpoint. Caller holds gStateLock (the rope is stepped under it).
+static void captureCheckpoint(void)
+{
+    Checkpoint* cp = &gCheckpoint;
+    memset(cp, 0, sizeof(*cp));
+    struct timespec now;
+    clock_gettime(CLOCK_REALTIME, &now);
+    cp->savedAtNs            = (int64_t)now.tv_sec * 1000000000LL + now.tv_nsec;
+    cp->gameId               = gGameId;
+    cp->rosterHash           = gRosterHash;
+    cp->roundNumber          = gState.roundNumber;
+    cp->scoreTeam1           = gState.scoreTeam1;
+    cp->scoreTeam2           = gState.scoreTeam2;
+    cp->consecutiveWinsTeam1 = gState.consecutiveWinsTeam1;
+    cp->consecutiveWinsTeam2 = gState.consecutiveWinsTeam2;
+    cp->winThreshold         = gState.winThreshold;
+    cp->maxRounds            = gState.maxRounds;
+    cp->consecutiveWinLimit  = gState.consecutiveWinLimit;
+    cp->sumTeam1             = gState.sumTeam1;
+    cp->sumTeam2             = gState.sumTeam2;
+    cp->roundInProgress      = roundInProgress;
+    cp->roundTick            = roundTickCount;
+    cp->totalTicks           = gTotalTicks;
+    cp->tickSeq              = gTickSeq;
+
+    cp->playerCount = gPlayers.count < CHECKPOINT_MAX_PLAYERS ? gPlayers.count : CHECKPOINT_MAX_PLAYERS;
+    for (int i = 0; i < cp->playerCount; i++) {
+        CheckpointPlayer* p = &cp->players[i];
+        p->id           = gPlayers.id[i];
+        p->energy       = gPlayers.energy[i];
+        p->flags        = gPlayers.flags[i];
+        p->rosterEnergy = playerRosterEnergy(i);
+        p->crashes      = gProcs[i].crashes;
+        int energy, factor, fallen;
+        if (!playerReportedState(i, &energy, &factor, &fallen)) {
+            // No report from this process yet: derive it from the referee's view
+            factor = playerFactor(&gPlayers, i);
+            fallen = playerFallen(&gPlayers, i);
+            energy = fallen ? 0 : gPlayers.energy[i] / (factor ? factor : 1);
+        }
+        p->reportedEnergy = energy;
+        p->reportedFactor = (uint8_t)factor;
+        p->reportedFallen = (uint8_t)fallen;
+    }
+
+    cp->ropeShift       = ropeShift;
+    cp->ropeTargetShift = ropeTargetShift;
+    cp->nodeCount       = gRope.numNodes < CHECKPOINT_MAX_NODES ? gRope.numNodes : CHECKPOINT_MAX_NODES;
+    for (int i = 0; i < cp->nodeCount; i++) {
+        const Node* n = &gRope.nodes[i];
+        cp->nodes[i].x  = (float)n->location.x;
+        cp->nodes[i].y  = (float)n->location.y;
+        cp->nodes[i].vx = (float)n->velocity.x;
+        cp->nodes[i].vy = (float)n->velocity.y;
+    }
+}
+
+// saveRoundCheckpoint
+// End of every round: capture under the lock, write outside it.
+static void saveRoundCheckpoint(void)
+{
+    if (!gConfig.checkpointFile) return;
+    long long start = monotonicNs();
+    pthread_mutex_lock(&gStateLock);
+    captureCheckpoint();
+    pthread_mutex_unlock(&gStateLock);
+    long long captured = monotonicNs();
+    if (saveCheckpoint(gConfig.checkpointFile, &gCheckpoint) == -1) return;
+    long long done = monotonicNs();
+
+    gCheckpointCount++;
+    gCheckpointTotalNs += done - start;
+    if (done - start > gCheckpointMaxNs) gCheckpointMaxNs = done - start;
+    printf("[Referee] Checkpoint after round %d: capture %.1f us, write %.1f us (%zu bytes) -> %s\n",
+           gState.roundNumber, (captured - start) / 1e3, (done - captured) / 1e3,
+           sizeof(Checkpoint), gConfig.checkpointFile);
+}
+
+static void printCheckpointStats(void)
+{
+    if (gCheckpointCount == 0) return;
+    printf("[Referee] Checkpoints: %d written, mean %.1f us, max %.1f us\n",
+           gCheckpointCount, gCheckpointTotalNs / 1e3 / gCheckpointCount, gCheckpointMaxNs / 1e3);
+}
+
+// resumeGame
+// Before the players are spawned: restore the game from a checkpoint
+// and hand each player its checkpointed state. The roster must be the
+// same one (IDs in the same order). Returns 0 on success, -1 on error.
+static int resumeGame(const char* path)
+{
+    long long start = monotonicNs();
+    Checkpoint* cp = &gCheckpoint;
+    if (loadCheckpoint(path, cp) == -1) return -1;
+    long long loaded = monotonicNs();
+
+    if (cp->playerCount != gPlayers.count) {
+        fprintf(stderr, "[Referee] Checkpoint has %d players, roster has %d\n", cp->playerCount, gPlayers.count);
+        return -1;
+    }
+    for (int i = 0; i < cp->playerCount; i++) {
+        if (cp->players[i].id != gPlayers.id[i]) {
+            fprintf(stderr, "[Referee] Checkpoint player %d is ID %d, roster has ID %d\n",
+                    i, cp->players[i].id, gPlayers.id[i]);
+            return -1;
+        }
+    }
 
-    glutTimerFunc(1000, timerRoundLogic, 0);
-    
+    gGameId                      = cp->gameId;
+    gRosterHash                  = cp->rosterHash;
+    gState.roundNumber           = cp->roundNumber;
+    gState.scoreTeam1            = cp->scoreTeam1;
+    gState.scoreTeam2            = cp->scoreTeam2;
+    gState.consecutiveWinsTeam1  = cp->consecutiveWinsTeam1;
+    gState.consecutiveWinsTeam2  = cp->consecutiveWinsTeam2;
+    gState.winThreshold          = cp->winThreshold;
+    gState.maxRounds             = cp->maxRounds;
+    gState.consecutiveWinLimit   = cp->consecutiveWinLimit;
+    gState.sumTeam1              = cp->sumTeam1;
+    gState.sumTeam2              = cp->sumTeam2;
+    roundInProgress              = cp->roundInProgress;
+    roundTickCount               = cp->roundTick;
+    gTotalTicks                  = cp->totalTicks;
+    gTickSeq                     = cp->tickSeq;
+    ropeShift                    = cp->ropeShift;
+    ropeTargetShift              = cp->ropeTargetShift;
+
+    for (int i = 0; i < cp->playerCount; i++) {
+        const CheckpointPlayer* p = &cp->players[i];
+        gPlayers.energy[i] = p->energy;
+        gPlayers.flags[i]  = p->flags;
+        setPlayerResumeState(i, p->rosterEnergy, p->reportedEnergy, p->reportedFactor,
+                             p->reportedFallen, p->crashes);
+    }
+    long long done = monotonicNs();
+    printf("[Referee] Resumed round %d (score %d-%d, %s) from %s: load %.1f us, restore %.1f us\n",
+           gState.roundNumber, gState.scoreTeam1, gState.scoreTeam2,
+           roundInProgress ? "mid-round" : "between rounds", path,
+           (loaded - start) / 1e3, (done - loaded) / 1e3);
+    return 0;
+}
+
+// resumeRope
+// After initRope: put the rope back where the checkpoint left it.
+static void resumeRope(void)
+{
+    const Checkpoint* cp = &gCheckpoint;
+    if (!gConfig.resumeFile || cp->nodeCount != gRope.numNodes) return;
+    for (int i = 0; i < gRope.numNodes; i++) {
+        Node* n = &gRope.nodes[i];
+        n->location.x = cp->nodes[i].x;
+        n->location.y = cp->nodes[i].y;
+        n->velocity.x = cp->nodes[i].vx;
+        n->velocity.y = cp->nodes[i].vy;
+        n->previous   = n->location;
+    }
+}
+
+// refereeLoop
+// Referee thread body (or the whole program when headless): one epoll
+// loop over the tick clock and every player's pidfd and energy pipe.
+// Player deaths and respawn handshakes are handled between ticks.
+static void* refereeLoop(void* arg)
+{
+    (void)arg;
+    pinThreadToCpus("Referee thread", gConfig.refereeCpus);
+    setThreadRealtime("Referee thread", gConfig.rtPriority);
+
+    struct epoll_event ev;
+    ev.events   = EPOLLIN;
+    ev.data.u32 = EV_TAG(EV_TICK, 0);
+    if (epoll_ctl(gEpollFD, EPOLL_CTL_ADD, gTickClock.fd, &ev) == -1) {
+        perror("epoll_ctl tick");
+        return NULL;
+    }
+
+    int running = 1;
+    while (running) {
+        struct epoll_event events[NUM_PLAYERS * 2 + 1];
+        int n = epoll_wait(gEpollFD, events, NUM_PLAYERS * 2 + 1, -1);
+        if (n == -1) {
+            if (errno == EINTR) continue;
+            perror("epoll_wait");
+            break;
+        }
+        for (int k = 0; k < n && running; k++) {
+            unsigned tag = events[k].data.u32;
+            if (EV_KIND(tag) == EV_TICK) {
+                if (tickClockWait(&gTickClock) <= 0) {
+                    running = 0;
+                    break;
+                }
+                traceBegin(TR_TICK, gTickClock.ticks);
+                running = refereeTick();
+                traceEnd(TR_TICK);
+            } else {
+                handlePlayerEvent(gEpollFD, tag);
+            }
+        }
+    }
+    printf("[Referee] Ticks run=%llu, missed=%llu, worst wake-up lateness=%.3f ms\n",
+           gTickClock.ticks, gTickClock.missed, gTickClock.maxLateNs / 1e6);
+    printTickJitter(&gTickClock);
+    printPlayerHealth();
+    tickClockClose(&gTickClock);
+    return NULL;
 }
 
 
@@ -261,8 +773,15 @@ static void timerRoundLogic(int val)
 // ============================
 void display() {
     glClear(GL_COLOR_BUFFER_BIT);
+    pthread_mutex_lock(&gStateLock);
     drawScene();
+    for (int i = 0; i < gRope.numNodes; i++) {
+        gRope.nodes[i].drawn = gRope.nodes[i].location;
+    }
+    gSceneDirty = 0;
+    pthread_mutex_unlock(&gStateLock);
     glutSwapBuffers();
+    __atomic_fetch_add(&gFramesDrawn, 1, __ATOMIC_RELAXED);
 }
 
 void reshape(int w, int h) {
@@ -275,23 +794,43 @@ void reshape(int w, int h) {
 void initOpenGL() {
     glClearColor(1, 1, 1, 1);
     glMatrixMode(GL_PROJECTION);
-    gluOrtho2D(0, 800, 0, 600);
+    gluOrtho2D(0, SCENE_WIDTH, 0, SCENE_HEIGHT);
+}
+
+// ropeMovedSinceDrawn
+// True once any node is more than ROPE_DRAW_EPSILON away from where the
+// last frame drew it (the players move with the end nodes).
+static int ropeMovedSinceDrawn(const Rope* rope)
+{
+    for (int i = 0; i < rope->numNodes; i++) {
+        const Node* n = &rope->nodes[i];
+        if (fabs(n->location.x - n->drawn.x) > ROPE_DRAW_EPSILON ||
+            fabs(n->location.y - n->drawn.y) > ROPE_DRAW_EPSILON) return 1;
+    }
+    return 0;
 }
 
 // updateScene: Computes ropeShift from energy sums and updates the rope.
 void updateScene() {
     // Smoothly animate towards target
     float animationSpeed = 0.1f;
+    pthread_mutex_lock(&gStateLock);
     ropeShift += (ropeTargetShift - ropeShift) * animationSpeed;
-    
-    // Update rope physics
-    updateRope(&gRope);
+    if (fabsf(ropeTargetShift - ropeShift) < 0.01f) ropeShift = ropeTargetShift;
+
+    // Update rope physics (no work while the rope is asleep). Stepped
+    // under the lock so a round-end checkpoint sees a whole step.
+    if (updateRope(&gRope, ropeShift) && ropeMovedSinceDrawn(&gRope)) {
+        markSceneDirty(SCENE_ROPE);
+    }
+    pthread_mutex_unlock(&gStateLock);
+    publishRopeView();
 }
 
 
 
 void drawScene() {
-    drawPlayers(gPlayers, NUM_PLAYERS);
+    drawPlayers(&gPlayers, gPlayerSprites);
     drawRope(&gRope);
 
 }
@@ -300,66 +839,64 @@ void drawScene() {
 // Player and Rope Functions (as previously defined)
 // ============================
 
-void initPlayers(Player players[], int count) {
-    double centerY = 300.0;
-    double spacing = 50.0;
+void initPlayerSprites(const PlayerTable* players, PlayerSprite sprites[]) {
+    float centerY = SCENE_Y;
+    float spacing = PLAYER_SPACING;
     int countTeam1 = 0, countTeam2 = 0;
-    for (int i = 0; i < count; i++) {
-        if (players[i].team == 1) {
-            players[i].position.x = 50.0 + (countTeam1 * spacing);
-            players[i].position.y = centerY;
+    for (int i = 0; i < players->count; i++) {
+        if (playerTeam(players, i) == 1) {
+            sprites[i].x = TEAM1_START_X + (countTeam1 * spacing);
+            sprites[i].y = centerY;
             countTeam1++;
         } else {
-            players[i].position.x = 750.0 - (countTeam2 * spacing);
-            players[i].position.y = centerY;
+            sprites[i].x = TEAM2_START_X - (countTeam2 * spacing);
+            sprites[i].y = centerY;
             countTeam2++;
         }
-        players[i].positionFactor = 1; // Default factor; could be updated by reordering.
-        players[i].fallen = 0;
     }
 }
 
 static void setColorForEnergy(double energy) {
-    if (energy >= 250) {
+    if (energy >= ENERGY_GREEN) {
         glColor3f(0.0f, 1.0f, 0.0f);  // green
-    } else if (energy >= 200) {
+    } else if (energy >= ENERGY_ORANGE) {
         glColor3f(1.0f, 0.65f, 0.0f); // orange
-    } else if (energy >= 150) {
+    } else if (energy >= ENERGY_YELLOW) {
         glColor3f(1.0f, 1.0f, 0.0f);  // yellow
     } else {
         glColor3f(0.0f, 0.0f, 0.0f);  // black
     }
 }
 
-void drawPlayers(const Player players[], int count) {
-    float playerOffsetX = ropeShift * 0.01f;
+void drawPlayers(const PlayerTable* players, const PlayerSprite sprites[]) {
+    if (!sprites) return;
 
-    for (int i = 0; i < count; i++) {
+    for (int i = 0; i < players->count; i++) {
         glPushMatrix();
-        glTranslatef(players[i].position.x + ropeShift * 0.05f, players[i].position.y, 0.0f);
+        glTranslatef(sprites[i].x + ropeShift * ROPE_SHIFT_SCALE, sprites[i].y, 0.0f);
 
 
-        if (players[i].fallen) {
+        if (playerFallen(players, i)) {
             // Draw fallen players smaller and grayed out
             glColor3f(0.5f, 0.5f, 0.5f); // gray
-            glScalef(0.7f, 0.7f, 1.0f);  // smaller size
+            glScalef(FALLEN_SCALE, FALLEN_SCALE, 1.0f);  // smaller size
             glRotatef(30.0f, 0.0f, 0.0f, 1.0f); // tilted
         } else {
-            setColorForEnergy(players[i].energy);
+            setColorForEnergy(players->energy[i]);
         }
 
-        if (players[i].team == 1) { // triangle
+        if (playerTeam(players, i) == 1) { // triangle
             glBegin(GL_TRIANGLES);
-                glVertex2f(-10.0f, -10.0f);
-                glVertex2f( 10.0f, -10.0f);
-                glVertex2f(  0.0f,  10.0f);
+                glVertex2f(-PLAYER_SIZE, -PLAYER_SIZE);
+                glVertex2f( PLAYER_SIZE, -PLAYER_SIZE);
+                glVertex2f(        0.0f,  PLAYER_SIZE);
             glEnd();
         } else { // circle
             glBegin(GL_POLYGON);
             for (int j = 0; j < 360; j++) {
                 float degRad = j * (M_PI / 180.0f);
-                float x = cosf(degRad) * 10.0f;
-                float y = sinf(degRad) * 10.0f;
+                float x = cosf(degRad) * PLAYER_SIZE;
+                float y = sinf(degRad) * PLAYER_SIZE;
                 glVertex2f(x, y);
             }
             glEnd();
@@ -371,7 +908,7 @@ void drawPlayers(const Player players[], int count) {
 
 
 
-void readConfigFile(const char* filename, Player players[], int maxPlayers) {
+void readConfigFile(const char* filename, PlayerTable* players) {
     FILE* fp = fopen(filename, "r");
     if (!fp) {
         perror("Could not open config file");
@@ -383,11 +920,16 @@ void readConfigFile(const char* filename, Player players[], int maxPlayers) {
         if (line[0] == '#' || line[0] == '\n') continue;
         int pid, tid;
         double eng;
-        if (sscanf(line, "%d %d %lf", &pid, &tid, &eng) == 3) {
-            if (idx < maxPlayers) {
-                players[idx].id = pid;
-                players[idx].team = tid;
-                players[idx].energy = eng;
+        char strategy[200];
+        int fields = sscanf(line, "%d %d %lf %199s", &pid, &tid, &eng, strategy);
+        if (fields >= 3) {
+            if (idx < players->count) {
+                players->id[idx] = pid;
+                setPlayerTeam(players, idx, tid);
+                players->energy[idx] = (int32_t)lround(eng);
+                setPlayerRosterEnergy(idx, eng);
+                // Optional 4th column: strategy file for this player
+                if (fields == 4 && strategy[0] != '#') setPlayerStrategy(idx, strdup(strategy));
                 idx++;
             }
         }
@@ -396,17 +938,27 @@ void readConfigFile(const char* filename, Player players[], int maxPlayers) {
 }
 
 // Rope functions
+#define ROPE_DAMPING     0.97   // velocity kept from one step to the next
+#define ROPE_CALM_STEPS  10     // calm steps in a row before the rope sleeps
+#define ROPE_WAKE_DELTA  0.01   // end-node movement (px) that wakes the rope
+
 void initRope(Rope* rope, int numNodes, double totalLength, double startX, double startY) {
+    memset(rope, 0, sizeof(*rope));
     rope->numNodes = numNodes;
     rope->nodes = (Node*)calloc(numNodes, sizeof(Node));
     rope->maxStretch = totalLength / (numNodes - 1);
+    rope->iterations = 8;
+    rope->tolerance  = 1e-3;
+    rope->sleepSpeed = 0.01;
     double spacing = totalLength / (numNodes - 1);
     for (int i = 0; i < numNodes; i++) {
         rope->nodes[i].location.x = startX + i * spacing;
         rope->nodes[i].location.y = startY;
         rope->nodes[i].velocity.x = 0.0;
         rope->nodes[i].velocity.y = 0.0;
-        rope->nodes[i].isFixed = (i == 0);
+        rope->nodes[i].previous   = rope->nodes[i].location;
+        rope->nodes[i].rest       = rope->nodes[i].location;
+        rope->nodes[i].isFixed = (i == 0 || i == numNodes - 1);  // held by the front players
         rope->nodes[i].above = (i > 0) ? &rope->nodes[i - 1] : NULL;
         rope->nodes[i].below = NULL;
         if (i > 0) {
@@ -415,45 +967,117 @@ void initRope(Rope* rope, int numNodes, double totalLength, double startX, doubl
     }
 }
 
-void updateRope(Rope* rope) {
-    if (!rope || !rope->nodes) return;
-    //pe->nodes[0].location.x = 180.0f + ropeShift;  // 350 is your original startX
-    // Apply tension between nodes.
+// ----------------------------
+// solveLinks
+// One Gauss-Seidel pass over the distance constraints: move each pair
+// of neighbours so their distance is the rest length again (fixed
+// nodes do not move). Returns the worst relative error seen.
+// ----------------------------
+static double solveLinks(Rope* rope) {
+    double worst = 0.0;
+    for (int i = 1; i < rope->numNodes; i++) {
+        Node* a = rope->nodes[i].above;
+        Node* b = &rope->nodes[i];
+        double dx = b->location.x - a->location.x;
+        double dy = b->location.y - a->location.y;
+        double dist = sqrt(dx * dx + dy * dy);
+        double error = dist - rope->maxStretch;
+        double relative = fabs(error) / rope->maxStretch;
+        if (relative > worst) worst = relative;
+
+        double wa = a->isFixed ? 0.0 : 1.0;
+        double wb = b->isFixed ? 0.0 : 1.0;
+        if (wa + wb == 0.0 || dist < 1e-9) continue;
+        double k = error / (dist * (wa + wb));
+        a->location.x += wa * k * dx;
+        a->location.y += wa * k * dy;
+        b->location.x -= wb * k * dx;
+        b->location.y -= wb * k * dy;
+    }
+    return worst;
+}
+
+// ----------------------------
+// updateRope
+// One position-based dynamics step:
+//   1. fixed end nodes move to their rest position plus the rope shift,
+//      free nodes coast on their damped velocity;
+//   2. up to rope->iterations constraint passes, stopping as soon as
+//      every link is within rope->tolerance of its rest length;
+//   3. velocities become the displacement of the step.
+// A rope that stays calm for ROPE_CALM_STEPS steps falls asleep and
+// costs nothing until the shift moves the end nodes again.
+// Returns 1 if the nodes moved, 0 if the rope slept through the step.
+// ----------------------------
+int updateRope(Rope* rope, double shift) {
+    if (!rope || !rope->nodes) return 0;
+    double offset = shift * ROPE_SHIFT_SCALE;
+    if (rope->asleep) {
+        if (fabs(offset - rope->lastOffset) < ROPE_WAKE_DELTA) {
+            rope->sleptSteps++;
+            return 0;
+        }
+        rope->asleep = 0;
+        rope->calmSteps = 0;
+    }
+    rope->steps++;
+    rope->lastOffset = offset;
+
     for (int i = 0; i < rope->numNodes; i++) {
         Node* n = &rope->nodes[i];
+        n->previous = n->location;
         if (n->isFixed) {
-            n->velocity.x = 0.0;
-            n->velocity.y = 0.0;
-            continue;
-        }
-        if (n->above) {
-            double dx = n->above->location.x - n->location.x;
-            double dy = n->above->location.y - n->location.y;
-            double dist = sqrt(dx * dx + dy * dy);
-            if (dist > rope->maxStretch) {
-                double overshoot = dist - rope->maxStretch;
-                double ratio = overshoot / dist;
-                double pullX = dx * ratio * 0.5;
-                double pullY = dy * ratio * 0.5;
-                n->velocity.x += pullX;
-                n->velocity.y += pullY;
-                if (!n->above->isFixed) {
-                    n->above->velocity.x -= pullX;
-                    n->above->velocity.y -= pullY;
-                }
-            }
+            n->location.x = n->rest.x + offset;
+            n->location.y = n->rest.y;
+        } else {
+            n->location.x += n->velocity.x * ROPE_DAMPING;
+            n->location.y += n->velocity.y * ROPE_DAMPING;
         }
     }
-    // Update node positions with friction and ropeShift.
+
+    double error = 0.0;
+    int pass = 0;
+    while (pass < rope->iterations) {
+        error = solveLinks(rope);
+        pass++;
+        if (error <= rope->tolerance) break;
+    }
+    rope->passes += pass;
+    rope->lastError = error;
+
+    double fastest = 0.0;
     for (int i = 0; i < rope->numNodes; i++) {
         Node* n = &rope->nodes[i];
-        if (!n->isFixed) {
-            n->location.x += n->velocity.x + ropeShift * 0.05;
-            n->location.y += n->velocity.y;
-            n->velocity.x *= 0.97;
-            n->velocity.y *= 0.97;
+        n->velocity.x = n->location.x - n->previous.x;
+        n->velocity.y = n->location.y - n->previous.y;
+        double speed = sqrt(n->velocity.x * n->velocity.x + n->velocity.y * n->velocity.y);
+        if (speed > fastest) fastest = speed;
+    }
+
+    if (fastest < rope->sleepSpeed && error <= rope->tolerance) {
+        if (++rope->calmSteps >= ROPE_CALM_STEPS) {
+            rope->asleep = 1;
+            for (int i = 0; i < rope->numNodes; i++) {
+                rope->nodes[i].velocity.x = 0.0;
+                rope->nodes[i].velocity.y = 0.0;
+            }
         }
+    } else {
+        rope->calmSteps = 0;
     }
+    return 1;
+}
+
+// ----------------------------
+// printRopeStats
+// How much of the run the rope solver actually worked.
+// ----------------------------
+void printRopeStats(const Rope* rope) {
+    unsigned long long total = rope->steps + rope->sleptSteps;
+    if (total == 0) return;
+    printf("[Referee] Rope: %llu frames, %llu simulated (%.1f%% asleep), %.2f passes per simulated frame (max %d), last error %.1e\n",
+           total, rope->steps, 100.0 * rope->sleptSteps / total,
+           rope->steps ? (double)rope->passes / rope->steps : 0.0, rope->iterations, rope->lastError);
 }
 
 void drawRope(const Rope* rope) {
@@ -4,6 +4,11 @@
 #ifndef M_PI
 #define M_PI 3.14159265358979323846
 #endif
+
+#include "player_table.h"
+#include "scene.h"
+
+#define NUM_PLAYERS 8 // 4 for Team1, 4 for Team2
 // parent.c
 extern float ropeShift;
 extern float ropeTargetShift;
@@ -18,30 +23,26 @@ typedef struct {
 } Vec2D;
 
 // ============================
-// Player Structure
-// - id: Unique player identifier (from config)
-// - team: 1 for Team 1, 2 for Team 2
-// - energy: Initial/current energy level
-// - position: Screen coordinates for visualization
-// - positionFactor: Factor (1,2,3,4) used for energy weighting (e.g., lowest energy gets factor 1)
-// - fallen: 0 = active, 1 = fallen
+// Players
+// - gPlayers: hot/cold PlayerTable (energy, factor/fallen/team flags, IDs)
+// - gPlayerSprites: screen positions, only allocated when a window is open
 // ============================
-typedef struct {
-    int    id;
-    int    team;
-    double energy;
-    Vec2D  position;
-    int    positionFactor;
-    int    fallen;
-} Player;
+extern PlayerTable   gPlayers;
+extern PlayerSprite* gPlayerSprites;
 
 // ============================
 // Rope Node and Rope Structure
 // - The rope is made up of nodes connected in a chain.
+// - The two end nodes are held by the front players and follow the
+//   rope shift; the nodes between are solved with position-based
+//   dynamics (distance constraints between neighbours).
 // ============================
 typedef struct Node {
     Vec2D location;
-    Vec2D velocity;
+    Vec2D velocity;   // displacement over the last step
+    Vec2D previous;   // location before the current step
+    Vec2D rest;       // location at zero shift (targets for fixed nodes)
+    Vec2D drawn;      // location in the last rendered frame
     int   isFixed;
     struct Node* above;
     struct Node* below;
@@ -50,12 +51,38 @@ typedef struct Node {
 typedef struct {
     Node*  nodes;
     int    numNodes;
-    double maxStretch;
+    double maxStretch;   // rest length between neighbouring nodes
+
+    // Solver settings
+    int    iterations;   // constraint passes per step (upper bound)
+    double tolerance;    // stop early once max |dist - rest| / rest is below this
+    double sleepSpeed;   // node speed (px/step) under which the rope may sleep
+
+    // Solver state and statistics
+    int    asleep;       // no work until the shift moves again
+    int    calmSteps;    // consecutive steps below sleepSpeed and tolerance
+    double lastOffset;   // end-node offset of the last simulated step
+    double lastError;    // max relative constraint error after the last step
+    unsigned long long steps;       // steps simulated
+    unsigned long long sleptSteps;  // steps skipped while asleep
+    unsigned long long passes;      // constraint passes run
 } Rope;
 
+// ============================
+// Render-on-demand dirty flags
+// - Set under gStateLock by whoever changes something visible; the
+//   render thread redraws only while a flag is set.
+// ============================
+#define SCENE_ROPE    0x1   // a rope node or the shift moved more than ROPE_DRAW_EPSILON
+#define SCENE_PLAYERS 0x2   // energy, factor or fallen state changed
+#define SCENE_ROUND   0x4   // round started or ended, sums or scores changed
+#define ROPE_DRAW_EPSILON 0.05  // px of movement worth a new frame
+
 // ============================
 // Function Prototypes for OpenGL & Scene Management
 // ============================
+void markSceneDirty(unsigned flags);
+void printRenderStats(void);
 void initOpenGL();
 void display();
 void reshape(int w, int h);
@@ -66,15 +93,16 @@ void drawScene();
 // ============================
 // Function Prototypes for Player Management
 // ============================
-void initPlayers(Player players[], int count);
-void drawPlayers(const Player players[], int count);
-void readConfigFile(const char* filename, Player players[], int maxPlayers);
+void initPlayerSprites(const PlayerTable* players, PlayerSprite sprites[]);
+void drawPlayers(const PlayerTable* players, const PlayerSprite sprites[]);
+void readConfigFile(const char* filename, PlayerTable* players);
 
 // ============================
 // Function Prototypes for Rope Management
 // ============================
 void initRope(Rope* rope, int numNodes, double totalLength, double startX, double startY);
-void updateRope(Rope* rope);
+int  updateRope(Rope* rope, double shift);
+void printRopeStats(const Rope* rope);
 void drawRope(const Rope* rope);
 void freeRope(Rope* rope);
 
@@ -6,77 +6,182 @@
    - Responds to parent's signals:
        SIGUSR1: GET_READY  (prepare/re-align; read updated factor)
        SIGUSR2: START_PULLING (begin or resume pulling, deplete energy)
-       SIGALRM: REPORT_ENERGY (report effective energy via pipe)
+       SIGALRM: REPORT_ENERGY (report effective energy via the team pipe;
+                the sigqueue() value is the tick sequence to echo back)
        SIGBUS:  FALL         (simulate falling: energy becomes 0)
+       SIGTERM: with --trace, dump the trace buffer before exiting
    - Updates global gEnergy and writes reported energy (if pipe is set).
+   - With --connect=<addr>, takes the same steps from CommandRecords
+     on a socket to the referee instead of pipes and signals.
+   - With --strategy=<file>, scales each report by the strategy's
+     effort and pays for it in energy (strategy.h).
 ============================
 */
 
 #define _POSIX_C_SOURCE 200809L
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <unistd.h>
 #include <signal.h>
+#include <poll.h>
 #include <time.h>
 
+#include "protocol.h"
+#include "strategy.h"
+#include "trace.h"
+#include "transport.h"
+
+#define CONNECT_TIMEOUT_NS 10000000000LL   // wait for the referee to listen
+
 // Global variables for the player's state
 static int    gPlayerID       = 0;
 static int    gTeamID         = 0;
 static double gEnergy         = 100.0;  // Initial energy; can be overridden by config
 static int    gPositionFactor = 1;      // Factor: 1, 2, 3, or 4 (based on alignment)
 static int    gFallen         = 0;      // 0: active, 1: fallen
+static int    gDepletionMin   = 5;      // Energy lost per START_PULLING: min..max
+static int    gDepletionMax   = 14;
+static double gRosterEnergy   = 100.0;  // Energy at the start of the game (effort recovery cap)
 
-// File descriptor for writing effective energy to parent (child -> parent)
+// Effort policy (default: always 1) and the round the current factor is for
+static Strategy  gStrategy;
+static RoundInfo gRound;
+
+// File descriptor for writing report records to parent (shared by the team)
 static int gWriteFD = -1;
 // File descriptor for reading updated factor from parent (parent -> child)
 static int gFactorReadFD = -1;
 
+// Tick sequence attached by the referee's sigqueue() (0 if sent with kill())
+static uint32_t signalSeq(const siginfo_t* info) {
+    return (info && info->si_code == SI_QUEUE) ? (uint32_t)info->si_value.sival_int : 0;
+}
+
 // ----------------------------
 // Signal Handler: GET_READY (SIGUSR1)
 // Child reads new factor from the factor pipe and updates gPositionFactor.
 // ----------------------------
-static void handleGetReady(int signum) {
+static void handleGetReady(int signum, siginfo_t* info, void* context) {
+    traceBegin(TR_GET_READY, signalSeq(info));
+    traceFlow('f', TRACE_FLOW_READY, signalSeq(info), gPlayerID);
     printf("[Player %d] Received GET_READY signal.\n", gPlayerID);
-    int newFactor = 0;
-    int bytesRead = read(gFactorReadFD, &newFactor, sizeof(newFactor));
+    FactorMessage msg;
+    traceBegin(TR_FACTOR_READ, 0);
+    int bytesRead = read(gFactorReadFD, &msg, sizeof(msg));
+    traceEnd(TR_FACTOR_READ);
     printf("[Player %d] read %d bytes from factor pipe.\n", gPlayerID, bytesRead);
-    if (bytesRead > 0) {
-        gPositionFactor = newFactor;
+    if (bytesRead == (int)sizeof(msg)) {
+        gPositionFactor = msg.factor;
+        gRound          = msg.round;
         fprintf(stderr, "[Player %d] Updated factor => %d\n", gPlayerID, gPositionFactor);
     } else {
         fprintf(stderr, "[Player %d] Failed to update factor (bytesRead=%d).\n", gPlayerID, bytesRead);
     }
+    traceEnd(TR_GET_READY);
 }
 
 
 // ----------------------------
-// Signal Handler: START_PULLING (SIGUSR2)
+// START_PULLING (SIGUSR2 or CMD_START_PULLING)
 // Child simulates pulling by depleting energy.
 // ----------------------------
-static void handleStartPulling(int signum) {
+static void startPulling(uint32_t seq) {
+    traceBegin(TR_START_PULLING, seq);
+    traceFlow('f', TRACE_FLOW_START, seq, gPlayerID);
     printf("[Player %d] Received START_PULLING signal. Beginning to pull...\n", gPlayerID);
     if (!gFallen) {
-        int decrease = rand() % 10 + 5;  // Decrease energy by 5 to 14 units.
+        // Decrease energy by gDepletionMin..gDepletionMax units (5 to 14 by default).
+        int decrease = gDepletionMin + rand() % (gDepletionMax - gDepletionMin + 1);
         gEnergy -= decrease;
         if (gEnergy < 0)
             gEnergy = 0;
         printf("[Player %d] gEnergy now: %.2f\n", gPlayerID, gEnergy);
     }
+    traceEnd(TR_START_PULLING);
+}
+
+// ----------------------------
+// sendRecord
+// One write() per record: records are <= PIPE_BUF, so they are never
+// interleaved with teammates' records on the shared team pipe.
+// ----------------------------
+static void sendRecord(uint8_t type, uint32_t seq, int32_t energy) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    ReportRecord rec;
+    memset(&rec, 0, sizeof(rec));
+    rec.type        = type;
+    rec.playerId    = (uint8_t)gPlayerID;
+    rec.fallen      = (uint8_t)gFallen;
+    rec.factor      = (uint8_t)gPositionFactor;
+    rec.seq         = seq;
+    rec.energy      = energy;
+    rec.pid         = (int32_t)getpid();
+    rec.ownEnergy   = gFallen ? 0 : (int32_t)(gEnergy + 0.5);
+    rec.timestampNs = (int64_t)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+    if (gWriteFD != -1 && write(gWriteFD, &rec, sizeof(rec)) == -1) {
+        perror("[Player] write error");
+    }
 }
 
 // ----------------------------
-// Signal Handler: REPORT_ENERGY (SIGALRM)
-// Child multiplies its energy by gPositionFactor and writes the result to the parent.
+// REPORT_ENERGY (SIGALRM or CMD_REPORT)
+// Child multiplies its energy by gPositionFactor and the strategy's effort and
+// writes the result to the parent, tagged with the tick sequence the referee
+// attached to the signal. The effort's cost comes out of gEnergy afterwards.
 // ----------------------------
-static void handleReportEnergy(int signum) {
-    double effective = gFallen ? 0 : (gEnergy * gPositionFactor);
+static void reportEnergy(uint32_t seq) {
+    traceBegin(TR_REPORT_ENERGY, seq);
+    traceFlow('t', TRACE_FLOW_REPORT, seq, gPlayerID);
+    StrategyContext ctx;
+    ctx.energy       = gEnergy;
+    ctx.rosterEnergy = gRosterEnergy;
+    ctx.factor       = gPositionFactor;
+    ctx.round        = gRound.round;
+    ctx.maxRounds    = gRound.maxRounds;
+    ctx.ownScore     = gTeamID == 2 ? gRound.scoreTeam2 : gRound.scoreTeam1;
+    ctx.otherScore   = gTeamID == 2 ? gRound.scoreTeam1 : gRound.scoreTeam2;
+    double effort = strategyEffort(&gStrategy, &ctx);
+    double effective = gFallen ? 0 : (gEnergy * gPositionFactor * effort);
     int reportValue = (int) effective;
-    printf("[Player %d] Reporting effective energy: %d (gEnergy: %.2f, Factor: %d)\n",
-           gPlayerID, reportValue, gEnergy, gPositionFactor);
-    if (gWriteFD != -1) {
-        if (write(gWriteFD, &reportValue, sizeof(reportValue)) == -1) {
-            perror("[Player] write error");
-        }
+    printf("[Player %d] Reporting effective energy: %d (gEnergy: %.2f, Factor: %d, effort %.2f, tick %u)\n",
+           gPlayerID, reportValue, gEnergy, gPositionFactor, effort, seq);
+    if (!gFallen) gEnergy = strategyFatigue(gEnergy, gRosterEnergy, effort);
+    traceBegin(TR_REPORT_WRITE, seq);
+    sendRecord(REPORT_ENERGY, seq, reportValue);
+    traceEnd(TR_REPORT_WRITE);
+    traceEnd(TR_REPORT_ENERGY);
+}
+
+static void handleStartPulling(int signum, siginfo_t* info, void* context) {
+    startPulling(signalSeq(info));
+}
+
+static void handleReportEnergy(int signum, siginfo_t* info, void* context) {
+    reportEnergy(signalSeq(info));
+}
+
+// ----------------------------
+// handleCommand
+// Socket transport: one record carries every step of a tick, in the
+// order the signals would have arrived.
+// ----------------------------
+static void handleCommand(const CommandRecord* cmd) {
+    if (cmd->flags & CMD_START_PULLING) {
+        startPulling(cmd->seq);
+    }
+    if (cmd->flags & CMD_SET_FACTOR) {
+        traceBegin(TR_GET_READY, cmd->seq);
+        traceFlow('f', TRACE_FLOW_READY, cmd->seq, gPlayerID);
+        gPositionFactor = cmd->factor;
+        gRound          = cmd->round;
+        fprintf(stderr, "[Player %d] Updated factor => %d\n", gPlayerID, gPositionFactor);
+        traceEnd(TR_GET_READY);
+    }
+    if (cmd->flags & CMD_REPORT) {
+        reportEnergy(cmd->seq);
     }
 }
 
@@ -90,54 +195,169 @@ static void handleFall(int signum) {
     gEnergy = 0;
 }
 
+// ----------------------------
+// Signal Handler: SIGTERM (only installed with --trace)
+// Write the trace buffer for the referee to merge, then exit.
+// ----------------------------
+static void handleTerminate(int signum) {
+    traceDump();
+    _exit(0);
+}
+
 // ----------------------------
 // Main Function
-// Expected arguments: <playerID> <teamID> <initialEnergy> <writeFD> <factorReadFD>
+// Expected arguments: <playerID> <teamID> <initialEnergy> <writeFD> <factorReadFD> [options]
+//                 or: <playerID> <teamID> <initialEnergy> --connect=<addr> [options]
+// Options: --connect=unix:<path> | tcp:<host>:<port> (socket transport)
+//          --depletion=<min>:<max>  --seed=<n> (0 = seed from the clock)
+//          --trace=<file> (dump a trace buffer to <file>.<pid>.bin on SIGTERM)
+//          --state=<energy>:<factor>:<fallen> (resume a checkpointed game)
+//          --strategy=<file> (effort policy written by ./evolve)
 // ----------------------------
 int main(int argc, char* argv[]) {
-    if (argc < 6) {
-        fprintf(stderr, "Usage: %s <playerID> <teamID> <initialEnergy> <writeFD> <factorReadFD>\n", argv[0]);
+    // Pipe FDs, or straight to the options with --connect
+    int firstOption = (argc >= 5 && strncmp(argv[4], "--", 2) == 0) ? 4 : 6;
+    if (argc < firstOption) {
+        fprintf(stderr, "Usage: %s <playerID> <teamID> <initialEnergy> <writeFD> <factorReadFD> [options]\n"
+                        "       %s <playerID> <teamID> <initialEnergy> --connect=<addr> [options]\n",
+                argv[0], argv[0]);
+        exit(EXIT_FAILURE);
+    }
+    unsigned seed = 0;
+    const char* tracePrefix = NULL;
+    const char* connectAddr = NULL;
+    const char* strategyFile = NULL;
+    int resumeEnergy = -1, resumeFactor = 1, resumeFallen = 0;
+    for (int i = firstOption; i < argc; i++) {
+        if (strncmp(argv[i], "--connect=", 10) == 0) {
+            connectAddr = argv[i] + 10;
+            continue;
+        }
+        if (sscanf(argv[i], "--depletion=%d:%d", &gDepletionMin, &gDepletionMax) == 2) continue;
+        if (sscanf(argv[i], "--seed=%u", &seed) == 1) continue;
+        if (sscanf(argv[i], "--state=%d:%d:%d", &resumeEnergy, &resumeFactor, &resumeFallen) == 3) continue;
+        if (strncmp(argv[i], "--strategy=", 11) == 0) {
+            strategyFile = argv[i] + 11;
+            continue;
+        }
+        if (strncmp(argv[i], "--trace=", 8) == 0) {
+            tracePrefix = argv[i] + 8;
+            continue;
+        }
+        fprintf(stderr, "[Player] Unknown option %s\n", argv[i]);
+        exit(EXIT_FAILURE);
+    }
+    if (gDepletionMin < 0 || gDepletionMax < gDepletionMin) {
+        fprintf(stderr, "[Player] Bad depletion range %d:%d\n", gDepletionMin, gDepletionMax);
         exit(EXIT_FAILURE);
     }
     gPlayerID     = atoi(argv[1]);
     gTeamID       = atoi(argv[2]);
     gEnergy       = atof(argv[3]);
-    gWriteFD      = atoi(argv[4]);
-    gFactorReadFD = atoi(argv[5]);
+    gRosterEnergy = gEnergy;
+    strategyDefault(&gStrategy);
+    if (strategyFile && loadStrategy(strategyFile, &gStrategy) == -1) {
+        fprintf(stderr, "[Player %d] Cannot load strategy %s\n", gPlayerID, strategyFile);
+        exit(EXIT_FAILURE);
+    }
+    if (connectAddr) {
+        TransportAddr addr;
+        if (parseTransportAddr(connectAddr, &addr) == -1) exit(EXIT_FAILURE);
+        gWriteFD = connectTransport(&addr, CONNECT_TIMEOUT_NS);
+        if (gWriteFD == -1) exit(EXIT_FAILURE);
+    } else if (firstOption == 6) {
+        gWriteFD      = atoi(argv[4]);
+        gFactorReadFD = atoi(argv[5]);
+    } else {
+        fprintf(stderr, "[Player] Need <writeFD> <factorReadFD> or --connect=<addr>\n");
+        exit(EXIT_FAILURE);
+    }
 
     gPositionFactor = 1;  // Default factor (will be updated via factor pipe)
     gFallen         = 0;
+    if (resumeEnergy >= 0) {
+        gEnergy         = resumeEnergy;
+        gPositionFactor = resumeFactor;
+        gFallen         = resumeFallen != 0;
+        printf("[Player %d] Resuming with gEnergy=%.2f, factor=%d%s\n",
+               gPlayerID, gEnergy, gPositionFactor, gFallen ? ", fallen" : "");
+    }
 
-    srand(time(NULL) + gPlayerID);
+    srand((seed ? seed : (unsigned)time(NULL)) + gPlayerID);
 
     printf("[Player %d] Starting. Team=%d, gEnergy=%.2f, gWriteFD=%d, gFactorReadFD=%d\n",
            gPlayerID, gTeamID, gEnergy, gWriteFD, gFactorReadFD);
 
+    if (strategyFile) {
+        char weights[160];
+        formatStrategy(&gStrategy, weights, sizeof(weights));
+        printf("[Player %d] Strategy %s: %s\n", gPlayerID, strategyFile, weights);
+    }
+
+    if (tracePrefix) {
+        traceOpen(tracePrefix, gPlayerID, gTeamID);
+    }
+
     // Set up signal handlers.
     struct sigaction sa;
     sa.sa_flags = 0;
     sigemptyset(&sa.sa_mask);
 
-    // GET_READY: SIGUSR1
-    sa.sa_handler = handleGetReady;
-    sigaction(SIGUSR1, &sa, NULL);
-
-    // START_PULLING: SIGUSR2
-    sa.sa_handler = handleStartPulling;
-    sigaction(SIGUSR2, &sa, NULL);
-
-    // REPORT_ENERGY: SIGALRM
-    sa.sa_handler = handleReportEnergy;
-    sigaction(SIGALRM, &sa, NULL);
+    // GET_READY, START_PULLING, REPORT_ENERGY: SIGUSR1, SIGUSR2, SIGALRM
+    // (need siginfo for the tick sequence)
+    struct sigaction saInfo;
+    saInfo.sa_flags = SA_SIGINFO;
+    sigemptyset(&saInfo.sa_mask);
+    saInfo.sa_sigaction = handleGetReady;
+    sigaction(SIGUSR1, &saInfo, NULL);
+    saInfo.sa_sigaction = handleStartPulling;
+    sigaction(SIGUSR2, &saInfo, NULL);
+    saInfo.sa_sigaction = handleReportEnergy;
+    sigaction(SIGALRM, &saInfo, NULL);
 
     // FALL: SIGBUS
     sa.sa_handler = handleFall;
     sigaction(SIGBUS, &sa, NULL);
 
-    // Main loop: wait indefinitely for signals.
-    while (1) {
-        pause();
+    // Referee shutdown: dump the trace first
+    if (tracePrefix) {
+        sa.sa_handler = handleTerminate;
+        sigaction(SIGTERM, &sa, NULL);
     }
 
+    // Ready handshake: tell the referee we can take signals now.
+    sendRecord(REPORT_READY, 0, 0);
+
+    // The referee starts us with these signals blocked; any that arrived
+    // before the handlers existed are delivered now.
+    sigset_t gameSignals;
+    sigemptyset(&gameSignals);
+    sigaddset(&gameSignals, SIGUSR1);
+    sigaddset(&gameSignals, SIGUSR2);
+    sigaddset(&gameSignals, SIGALRM);
+    sigaddset(&gameSignals, SIGBUS);
+    sigprocmask(SIG_UNBLOCK, &gameSignals, NULL);
+
+    // Socket transport: one command per tick until the referee hangs up.
+    if (connectAddr) {
+        CommandRecord cmd;
+        while (readFull(gWriteFD, &cmd, sizeof(cmd)) == 1) {
+            handleCommand(&cmd);
+        }
+        printf("[Player %d] Referee closed the connection.\n", gPlayerID);
+        traceDump();
+        return 0;
+    }
+
+    // Main loop: handle signals until the referee goes away. It holds
+    // the only write end of our factor pipe, so the pipe hangs up when
+    // the referee exits, even if it is killed without stopping us.
+    struct pollfd hangup = { .fd = gFactorReadFD, .events = 0 };
+    while (1) {
+        // EINTR after each game signal; only a hang-up ends the loop
+        if (poll(&hangup, 1, -1) == 1 && (hangup.revents & (POLLHUP | POLLERR))) break;
+    }
+    printf("[Player %d] Referee closed the factor pipe.\n", gPlayerID);
+    traceDump();
     return 0;
 }
\ No newline at end of file
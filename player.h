@@ -8,15 +8,18 @@
   Contains declarations and data structures related to a single player's logic.
 */
 
+#include <signal.h>
+
 #ifdef __cplusplus
 extern "C" {
 #endif
 
 // Setup signal handlers for GET_READY, START_PULLING, REPORT_ENERGY, FALL
-void handleGetReady(int signum);
-void handleStartPulling(int signum);
-void handleReportEnergy(int signum);
+void handleGetReady(int signum, siginfo_t* info, void* context);
+void handleStartPulling(int signum, siginfo_t* info, void* context);
+void handleReportEnergy(int signum, siginfo_t* info, void* context);
 void handleFall(int signum);
+void handleTerminate(int signum);
 
 int main(int argc, char* argv[]);
 
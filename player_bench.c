@@ -0,0 +1,233 @@
+/*
+============================
+        player_bench.c
+   Round-logic benchmark on large in-memory rosters:
+   - Builds the same random roster in the old array-of-structs layout
+     (one 40-byte Player per player, render position included) and in
+     the hot/cold PlayerTable
+   - Times factor assignment (once per round) and energy collection
+     (once per tick): the old algorithms on the old layout, the table's
+     algorithms (radix sort, branch-free sums) on the old layout, and
+     the table itself, and checks they agree
+   - Prints bytes per player and splits the speed-up into the part
+     due to the algorithms and the part due to the layout
+   Usage: player_bench [players] [rounds] [ticks per round]
+============================
+*/
+
+#include "player_table.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+// ============================
+// Layout before the hot/cold split (parent.h)
+// ============================
+typedef struct {
+    double x;
+    double y;
+} Vec2D;
+
+typedef struct {
+    int    id;
+    int    team;
+    double energy;
+    Vec2D  position;
+    int    positionFactor;
+    int    fallen;
+} Player;
+
+static long long nowNs(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (long long)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+// ----------------------------
+// Array-of-structs round logic
+// Same algorithm the referee used: copy a team's Players out, sort
+// them by energy, assign factors by rank and map them back by ID.
+// ----------------------------
+static int cmpEnergy(const void* a, const void* b) {
+    double ea = ((const Player*)a)->energy, eb = ((const Player*)b)->energy;
+    if (ea != eb) return ea < eb ? -1 : 1;
+    return ((const Player*)a)->id - ((const Player*)b)->id;
+}
+
+static void aosReorder(Player players[], int count, Player* team, const int indexById[]) {
+    for (int t = 1; t <= 2; t++) {
+        int n = 0;
+        for (int i = 0; i < count; i++) {
+            if (players[i].team == t) team[n++] = players[i];
+        }
+        qsort(team, n, sizeof(Player), cmpEnergy);
+        for (int r = 0; r < n; r++) {
+            team[r].positionFactor = 1 + (int)((long long)r * NUM_FACTORS / n);
+            players[indexById[team[r].id]].positionFactor = team[r].positionFactor;
+        }
+    }
+}
+
+// ----------------------------
+// Array-of-structs, table algorithms
+// assignFactors and sumTeamEnergies line for line, reading and writing
+// the 40-byte Player records instead of the packed arrays.
+// ----------------------------
+static void aosRadixReorder(Player players[], int count, uint64_t* keys, uint64_t* tmp) {
+    for (int t = 1; t <= 2; t++) {
+        int n = 0;
+        for (int i = 0; i < count; i++) {
+            if (players[i].team != t) continue;
+            uint32_t e = (uint32_t)(int32_t)players[i].energy ^ 0x80000000u;
+            keys[n++] = ((uint64_t)e << 32) | (uint32_t)i;
+        }
+        const uint64_t* sorted = sortEnergyKeys(keys, tmp, n);
+        for (int r = 0; r < n; r++) {
+            players[(uint32_t)sorted[r]].positionFactor = 1 + (int)((int64_t)r * NUM_FACTORS / n);
+        }
+    }
+}
+
+static void aosBranchFreeCollect(Player players[], int count, const int32_t reports[],
+                                 int64_t* sum1, int64_t* sum2) {
+    int64_t s1 = 0, s2 = 0;
+    for (int i = 0; i < count; i++) {
+        int32_t r     = reports[i];
+        int32_t take  = -(int32_t)((players[i].fallen == 0) & (r >= 0));
+        int32_t team2 = -(int32_t)(players[i].team == 2);
+        int32_t v     = r & take;
+        players[i].energy = take ? (double)v : players[i].energy;
+        s1 += v & ~team2;
+        s2 += v & team2;
+    }
+    *sum1 = s1;
+    *sum2 = s2;
+}
+
+static void aosCollect(Player players[], int count, const int32_t reports[], int64_t* sum1, int64_t* sum2) {
+    int64_t s1 = 0, s2 = 0;
+    for (int i = 0; i < count; i++) {
+        if (players[i].fallen || reports[i] < 0) continue;
+        players[i].energy = (double)reports[i];
+        if (players[i].team == 1) {
+            s1 += reports[i];
+        } else {
+            s2 += reports[i];
+        }
+    }
+    *sum1 = s1;
+    *sum2 = s2;
+}
+
+int main(int argc, char* argv[]) {
+    int count  = argc > 1 ? atoi(argv[1]) : 1000000;
+    int rounds = argc > 2 ? atoi(argv[2]) : 10;
+    int ticks  = argc > 3 ? atoi(argv[3]) : 10;
+    if (count < 2 || rounds < 1 || ticks < 1) {
+        fprintf(stderr, "Usage: %s [players] [rounds] [ticks per round]\n", argv[0]);
+        exit(EXIT_FAILURE);
+    }
+
+    Player*  aos      = calloc(count, sizeof(Player));
+    Player*  aosTeam  = malloc((size_t)count * sizeof(Player));
+    int*     indexById = malloc((size_t)count * sizeof(int));
+    Player*  aos2     = malloc((size_t)count * sizeof(Player));   // table algorithms
+    uint64_t* keys    = malloc(2 * (size_t)count * sizeof(uint64_t));
+    int32_t* reports  = malloc((size_t)count * sizeof(int32_t));
+    PlayerTable soa;
+    if (!aos || !aosTeam || !indexById || !aos2 || !keys || !reports ||
+        playerTableInit(&soa, count) == -1) {
+        perror("alloc");
+        exit(EXIT_FAILURE);
+    }
+
+    srand(1);
+    for (int i = 0; i < count; i++) {
+        int team   = (i & 1) + 1;
+        int energy = 50 + rand() % 400;
+        aos[i].id     = i;
+        aos[i].team   = team;
+        aos[i].energy = energy;
+        aos[i].positionFactor = 1;
+        indexById[i]  = i;
+        soa.id[i]     = i;
+        soa.energy[i] = energy;
+        setPlayerTeam(&soa, i, team);
+        if (rand() % 50 == 0) {   // a few fallen players
+            aos[i].fallen = 1;
+            setPlayerFallen(&soa, i, 1);
+        }
+    }
+    memcpy(aos2, aos, (size_t)count * sizeof(Player));
+
+    long long aosReorderNs = 0, soaReorderNs = 0, aosCollectNs = 0, soaCollectNs = 0;
+    long long aos2ReorderNs = 0, aos2CollectNs = 0;
+    int64_t aosSum1 = 0, aosSum2 = 0, soaSum1 = 0, soaSum2 = 0, aos2Sum1 = 0, aos2Sum2 = 0;
+    int mismatches = 0;
+
+    for (int r = 0; r < rounds; r++) {
+        long long t0 = nowNs();
+        aosReorder(aos, count, aosTeam, indexById);
+        long long t1 = nowNs();
+        aosRadixReorder(aos2, count, keys, keys + count);
+        long long t2 = nowNs();
+        assignFactors(&soa);
+        long long t3 = nowNs();
+        aosReorderNs  += t1 - t0;
+        aos2ReorderNs += t2 - t1;
+        soaReorderNs  += t3 - t2;
+
+        for (int i = 0; i < count; i++) {
+            if (aos[i].positionFactor != playerFactor(&soa, i)) mismatches++;
+            if (aos2[i].positionFactor != playerFactor(&soa, i)) mismatches++;
+        }
+
+        for (int k = 0; k < ticks; k++) {
+            for (int i = 0; i < count; i++) {
+                // Same depletion for both layouts; ~1% of players miss the tick
+                reports[i] = (rand() % 100 == 0) ? -1 : soa.energy[i] - (soa.energy[i] > 5 ? rand() % 5 : 0);
+            }
+            t0 = nowNs();
+            aosCollect(aos, count, reports, &aosSum1, &aosSum2);
+            t1 = nowNs();
+            aosBranchFreeCollect(aos2, count, reports, &aos2Sum1, &aos2Sum2);
+            t2 = nowNs();
+            sumTeamEnergies(&soa, reports, &soaSum1, &soaSum2);
+            t3 = nowNs();
+            aosCollectNs  += t1 - t0;
+            aos2CollectNs += t2 - t1;
+            soaCollectNs  += t3 - t2;
+            if (aosSum1 != soaSum1 || aosSum2 != soaSum2) mismatches++;
+            if (aos2Sum1 != soaSum1 || aos2Sum2 != soaSum2) mismatches++;
+        }
+    }
+
+    double perRound = (double)rounds;
+    double perTick  = (double)rounds * ticks;
+    printf("%d players, %d rounds x %d ticks\n", count, rounds, ticks);
+    printf("%-42s %12s %12s %20s\n", "layout / algorithms", "reorder ms", "collect ms",
+           "round logic B/player");
+    printf("%-42s %12.3f %12.3f %20zu\n", "array of structs / qsort, branches",
+           aosReorderNs / perRound / 1e6, aosCollectNs / perTick / 1e6, sizeof(Player));
+    printf("%-42s %12.3f %12.3f %20zu\n", "array of structs / radix, branch-free",
+           aos2ReorderNs / perRound / 1e6, aos2CollectNs / perTick / 1e6, sizeof(Player));
+    printf("%-42s %12.3f %12.3f %20zu\n", "hot/cold PlayerTable / radix, branch-free",
+           soaReorderNs / perRound / 1e6, soaCollectNs / perTick / 1e6, playerHotBytes());
+    printf("speed-up from the algorithms: reorder x%.2f, collect x%.2f\n",
+           (double)aosReorderNs / aos2ReorderNs, (double)aosCollectNs / aos2CollectNs);
+    printf("speed-up from the layout:     reorder x%.2f, collect x%.2f\n",
+           (double)aos2ReorderNs / soaReorderNs, (double)aos2CollectNs / soaCollectNs);
+    printf("last sums T1=%lld T2=%lld; mismatches=%d\n",
+           (long long)soaSum1, (long long)soaSum2, mismatches);
+    printPlayerFootprint(&soa, 0);
+
+    playerTableFree(&soa);
+    free(aos);
+    free(aosTeam);
+    free(indexById);
+    free(aos2);
+    free(keys);
+    free(reports);
+    return mismatches ? EXIT_FAILURE : 0;
+}
@@ -0,0 +1,986 @@
+/*
+============================
+       player_procs.c
+   Referee-side player process management:
+   - Forks/execs players with a shared per-team report pipe and a
+     private factor pipe
+   - Watches each child through a pidfd in the referee's epoll loop
+   - Marks dead players fallen immediately and respawns a replacement
+     in the background (ready handshake over the report pipe)
+   - Sends signals/factors and drains each team's framed reports with
+     one read() per team, dropping stale or duplicated ones by sequence
+   - Socket transport: accepts one connection per player and sends a
+     single CommandRecord per player per tick
+============================
+*/
+
+#define _GNU_SOURCE
+#include "player_procs.h"
+#include "parent.h"
+#include "config.h"
+#include "protocol.h"
+#include "tick_clock.h"
+#include "sched_tune.h"
+#include "trace.h"
+#include "transport.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <sys/syscall.h>
+#include <sys/wait.h>
+
+#define READY_TIMEOUT_NS 5000000000LL  // initial handshake wait (wall clock)
+#define NUM_TEAMS        2
+#define REPORT_BATCH     64              // records drained per read()
+#define MAX_NEW_CONNS    16              // accepted connections not yet identified
+
+extern PlayerTable     gPlayers;
+extern GameConfig      gConfig;
+extern pthread_mutex_t gStateLock;
+
+PlayerProc gProcs[NUM_PLAYERS];
+
+static int32_t            gInitialEnergy[NUM_PLAYERS];  // roster energy for replacements
+static double             gRosterEnergy[NUM_PLAYERS];   // ... as written in the roster, for players
+static int                gRejoinPending[NUM_PLAYERS];  // replacement waits for next round
+static int                gIndexById[256];              // roster ID -> gPlayers index (-1 = unknown)
+
+// Process state from the last accepted energy report (for checkpoints),
+// and state a resumed game hands to the first spawn of each player.
+typedef struct {
+    int valid;
+    int energy;   // before the factor
+    int factor;
+    int fallen;
+} PlayerProcState;
+
+static PlayerProcState gReportedState[NUM_PLAYERS];
+static PlayerProcState gResumeState[NUM_PLAYERS];
+
+static const char* gStrategyFile[NUM_PLAYERS];   // roster strategy column (NULL = default)
+
+// One report pipe per team, shared by its players. The referee keeps the
+// write end open so replacements can inherit it.
+static int gTeamPipe[NUM_TEAMS][2] = { { -1, -1 }, { -1, -1 } };
+
+// Per-tick bookkeeping for gatherReports()
+static uint32_t gCurrentSeq = 0;
+static uint32_t gReportedSeq[NUM_PLAYERS];   // last seq accepted per player
+static int      gTickReports[NUM_PLAYERS];   // energy accepted this tick
+
+// Socket transport: connection slots 0..NUM_PLAYERS-1 belong to the
+// player with that index; the rest hold connections until their READY
+// record says who they are. Commands are staged per player and sent
+// as one record when the tick's REPORT_ENERGY goes out.
+typedef struct {
+    int     fd;       // -1 = free
+    size_t  len;      // bytes of a partial record kept in buf
+    uint8_t buf[REPORT_BATCH * sizeof(ReportRecord)];
+} SocketConn;
+
+static TransportAddr gListenAddr;
+static int           gListenFD = -1;
+static int           gLoopFD   = -1;    // referee epoll fd (for disconnects found while draining)
+static SocketConn    gConns[NUM_PLAYERS + MAX_NEW_CONNS];
+static CommandRecord gPendingCmd[NUM_PLAYERS];
+
+static unsigned long long gCommandsSent = 0;
+static unsigned long long gCommandDrops = 0;  // socket buffer full or connection gone
+
+static unsigned long long gLateReports  = 0;  // players that missed the deadline
+static unsigned long long gStaleReports = 0;  // answers to an earlier tick
+static unsigned long long gDupReports   = 0;  // second answer to the same tick
+static unsigned long long gForeignRecs  = 0;  // unknown player or replaced process
+static unsigned long long gReportReads  = 0;  // read() calls on report pipes / sockets, EAGAIN included
+static unsigned long long gTickReads    = 0;  // ... of those, made while gathering a tick
+static unsigned long long gReportTicks  = 0;
+
+static int teamSlot(int team) {
+    return team == 2 ? 1 : 0;
+}
+
+// ----------------------------
+// openPidfd
+// Returns -1 when the kernel has no pidfd_open; the referee then
+// falls back to reapPlayers() polling once per tick.
+// ----------------------------
+static int openPidfd(pid_t pid) {
+#ifdef SYS_pidfd_open
+    return (int)syscall(SYS_pidfd_open, pid, 0);
+#else
+    (void)pid;
+    errno = ENOSYS;
+    return -1;
+#endif
+}
+
+static void watchFD(int epfd, int fd, unsigned tag) {
+    struct epoll_event ev;
+    ev.events   = EPOLLIN;
+    ev.data.u32 = tag;
+    if (epoll_ctl(epfd, EPOLL_CTL_ADD, fd, &ev) == -1) {
+        perror("epoll_ctl add");
+    }
+}
+
+// ----------------------------
+// spawnPlayer
+// Fork/exec one player for slot i. Pipes are close-on-exec so a
+// respawned child never inherits another player's pipe ends.
+// ----------------------------
+static void spawnPlayer(int epfd, int i) {
+    int socketMode = (gListenFD != -1);   // the player connects back instead
+    int reportFD = socketMode ? -1 : gTeamPipe[teamSlot(playerTeam(&gPlayers, i))][1];
+    int fdsFactor[2] = { -1, -1 };
+    if (!socketMode && pipe2(fdsFactor, O_CLOEXEC) == -1) {
+        perror("pipe factor");
+        exit(1);
+    }
+
+    // Everything the child needs is built here: after fork() in this
+    // multithreaded process the child may only make async-signal-safe
+    // calls (no stdio, no malloc) before execl.
+    char argID[10], argTeam[10], argEnergy[20];
+    char argWriteFD[10], argFactorReadFD[10];
+    char argDepletion[32], argSeed[32], argTrace[600], argState[48], argConnect[600], argStrategy[600];
+    snprintf(argID, sizeof(argID), "%d", gPlayers.id[i]);
+    snprintf(argTeam, sizeof(argTeam), "%d", playerTeam(&gPlayers, i));
+    snprintf(argEnergy, sizeof(argEnergy), "%.1f", gRosterEnergy[i]);
+    snprintf(argWriteFD, sizeof(argWriteFD), "%d", reportFD);
+    snprintf(argFactorReadFD, sizeof(argFactorReadFD), "%d", fdsFactor[0]);
+    snprintf(argDepletion, sizeof(argDepletion), "--depletion=%d:%d", gConfig.depletionMin, gConfig.depletionMax);
+    snprintf(argSeed, sizeof(argSeed), "--seed=%u", gConfig.seed);
+    snprintf(argTrace, sizeof(argTrace), "--trace=%s", gConfig.traceFile ? gConfig.traceFile : "");
+    const PlayerProcState* resume = &gResumeState[i];
+    snprintf(argState, sizeof(argState), "--state=%d:%d:%d", resume->energy, resume->factor, resume->fallen);
+    snprintf(argStrategy, sizeof(argStrategy), "--strategy=%s", gStrategyFile[i] ? gStrategyFile[i] : "");
+    snprintf(argConnect, sizeof(argConnect), "--connect=%s", gConfig.listenAddr ? gConfig.listenAddr : "");
+
+    // Optional arguments go last; the first NULL ends the list.
+    char* optional[4] = { NULL, NULL, NULL, NULL };
+    int nOptional = 0;
+    if (resume->valid)     optional[nOptional++] = argState;
+    if (gConfig.traceFile) optional[nOptional++] = argTrace;
+    if (gStrategyFile[i])  optional[nOptional++] = argStrategy;
+
+    // Optional CPU pin / SCHED_FIFO; otherwise undo whatever the
+    // (possibly pinned, real-time) referee thread passed on.
+    PlayerSched sched;
+    preparePlayerSched(&sched, gConfig.playerCpus, gConfig.playerRtPriority, i);
+
+    // Keep game signals pending until the player has installed its
+    // handlers (the mask survives execl).
+    sigset_t gameSignals;
+    sigemptyset(&gameSignals);
+    sigaddset(&gameSignals, SIGUSR1);
+    sigaddset(&gameSignals, SIGUSR2);
+    sigaddset(&gameSignals, SIGALRM);
+    sigaddset(&gameSignals, SIGBUS);
+    static const char execFailed[] = "[Referee] execl ./player failed\n";
+
+    pid_t pid = fork();
+    if (pid < 0) {
+        perror("fork");
+        exit(1);
+    }
+    if (pid == 0) {
+        // CHILD: only our team's report pipe and our factor pipe survive execl
+        if (!socketMode) {
+            fcntl(reportFD, F_SETFD, 0);
+            fcntl(fdsFactor[0], F_SETFD, 0);
+        }
+
+        // The referee ignores SIGPIPE; players keep the default.
+        signal(SIGPIPE, SIG_DFL);
+
+        applyPlayerSched(&sched);
+        sigprocmask(SIG_BLOCK, &gameSignals, NULL);
+
+        if (socketMode) {
+            // execl => <playerID> <teamID> <initEnergy> --connect=<addr> [options]
+            execl("./player", "player",
+                  argID, argTeam, argEnergy, argConnect,
+                  argDepletion, argSeed,
+                  optional[0], optional[1], optional[2],
+                  (char*)NULL);
+        } else {
+            // execl => <playerID> <teamID> <initEnergy> <writeFD> <factorReadFD> [options]
+            execl("./player", "player",
+                  argID, argTeam, argEnergy,
+                  argWriteFD, argFactorReadFD,
+                  argDepletion, argSeed,
+                  optional[0], optional[1], optional[2],
+                  (char*)NULL);
+        }
+        write(STDERR_FILENO, execFailed, sizeof(execFailed) - 1);
+        _exit(1);
+    }
+
+    // PARENT
+    if (fdsFactor[0] != -1) close(fdsFactor[0]);  // child reads
+    gResumeState[i].valid = 0;   // replacements start from the roster again
+
+    PlayerProc* p = &gProcs[i];
+    p->pid      = pid;
+    p->factorFD = fdsFactor[1];
+    p->state    = PROC_STARTING;
+    p->pidfd    = openPidfd(pid);
+    traceNoteChild(pid);
+    if (p->pidfd == -1 && errno != ENOSYS) {
+        perror("pidfd_open");
+    }
+
+    if (p->pidfd != -1) {
+        watchFD(epfd, p->pidfd, EV_TAG(EV_PIDFD, i));
+    }
+}
+
+// ----------------------------
+// markReady
+// Handshake received: the process can take part from now on.
+// A replacement rejoins (un-fallen, roster energy) at the next round.
+// ----------------------------
+static void markReady(int i) {
+    PlayerProc* p = &gProcs[i];
+    if (p->state != PROC_STARTING) return;
+    p->state = PROC_ALIVE;
+
+    if (p->diedAtNs) {
+        long long latency = monotonicNs() - p->diedAtNs;
+        p->respawns++;
+        p->lastRespawnNs   = latency;
+        p->totalRespawnNs += latency;
+        if (latency > p->maxRespawnNs) p->maxRespawnNs = latency;
+        p->diedAtNs = 0;
+        gRejoinPending[i] = 1;
+        printf("[Referee] Player %d respawned in %.3f ms (crash #%d), rejoins next round\n",
+               gPlayers.id[i], latency / 1e6, p->crashes);
+    }
+}
+
+// ----------------------------
+// acceptRecord
+// Validate one report record from player i. Energy for the current tick
+// is stored in gTickReports; anything older or repeated is counted and
+// dropped. Returns 1 if it was a fresh report for the current tick.
+// ----------------------------
+static int acceptRecord(int i, const ReportRecord* rec) {
+    if (rec->type == REPORT_READY) {
+        markReady(i);
+        return 0;
+    }
+    if (rec->type != REPORT_ENERGY) {
+        gForeignRecs++;
+        return 0;
+    }
+    if (rec->seq != gCurrentSeq || gCurrentSeq == 0) {
+        gStaleReports++;
+        return 0;
+    }
+    if (gReportedSeq[i] == rec->seq) {
+        gDupReports++;
+        return 0;
+    }
+    gReportedSeq[i]  = rec->seq;
+    gTickReports[i]  = rec->energy;
+
+    PlayerProcState* st = &gReportedState[i];
+    st->valid  = 1;
+    st->factor = rec->factor ? rec->factor : 1;
+    st->fallen = rec->fallen;
+    st->energy = rec->fallen ? 0 : rec->ownEnergy;   // after the tick's effort and fatigue
+    traceFlow('f', TRACE_FLOW_REPORT, rec->seq, rec->playerId);
+    return 1;
+}
+
+// ----------------------------
+// handleRecord
+// A record from a team pipe: find the sender by player ID, and drop it
+// if that player's process has since been replaced.
+// ----------------------------
+static int handleRecord(const ReportRecord* rec) {
+    int i = gIndexById[rec->playerId];
+    if (i < 0 || gProcs[i].state == PROC_DEAD || rec->pid != gProcs[i].pid) {
+        gForeignRecs++;
+        return 0;
+    }
+    return acceptRecord(i, rec);
+}
+
+// ----------------------------
+// drainTeam
+// Read every record queued on a team's report pipe with as few read()
+// calls as possible (normally one). Returns the number of fresh
+// reports for the current tick.
+// ----------------------------
+static int drainTeam(int team) {
+    ReportRecord batch[REPORT_BATCH];
+    int fresh = 0;
+    for (;;) {
+        ssize_t n = read(gTeamPipe[team][0], batch, sizeof(batch));
+        gReportReads++;
+        if (n > 0) {
+            for (size_t k = 0; k < (size_t)n / sizeof(ReportRecord); k++) {
+                fresh += handleRecord(&batch[k]);
+            }
+            if ((size_t)n < sizeof(batch)) return fresh;  // pipe is empty now
+            continue;
+        }
+        if (n == -1 && errno == EINTR) continue;
+        return fresh;  // EAGAIN: nothing (more) queued
+    }
+}
+
+// ============================
+// Socket transport
+// ============================
+static void initConns(void) {
+    for (size_t s = 0; s < sizeof(gConns) / sizeof(gConns[0]); s++) {
+        gConns[s].fd  = -1;
+        gConns[s].len = 0;
+    }
+}
+
+static void closeConn(int slot) {
+    SocketConn* c = &gConns[slot];
+    if (c->fd == -1) return;
+    close(c->fd);   // also removes it from epoll
+    c->fd  = -1;
+    c->len = 0;
+}
+
+// ----------------------------
+// acceptPlayers
+// Take every pending connection into a free unidentified slot; it
+// becomes a player's connection once its READY record arrives.
+// ----------------------------
+static void acceptPlayers(int epfd) {
+    for (;;) {
+        int fd = acceptTransport(gListenFD, &gListenAddr);
+        if (fd == -1) return;
+        int slot = -1;
+        for (int s = NUM_PLAYERS; s < NUM_PLAYERS + MAX_NEW_CONNS; s++) {
+            if (gConns[s].fd == -1) {
+                slot = s;
+                break;
+            }
+        }
+        if (slot == -1) {
+            fprintf(stderr, "[Referee] Too many unidentified connections; closing one\n");
+            close(fd);
+            continue;
+        }
+        gConns[slot].fd  = fd;
+        gConns[slot].len = 0;
+        watchFD(epfd, fd, EV_TAG(EV_SOCKET, slot));
+    }
+}
+
+// ----------------------------
+// identifyConn
+// First record on a new connection: a READY from a roster player that
+// is expected to (re)join. Moves the connection to the player's slot.
+// Returns the player index, or -1 (connection closed).
+// ----------------------------
+static int identifyConn(int slot, const ReportRecord* rec) {
+    int i = rec->type == REPORT_READY ? gIndexById[rec->playerId] : -1;
+    const char* why = NULL;
+    if (i < 0) {
+        why = "not a READY from a roster player";
+    } else if (gConns[i].fd != -1) {
+        why = "player already connected";
+    } else if (gProcs[i].pid > 0 && rec->pid != gProcs[i].pid) {
+        why = "not the process the referee started";
+    } else if (gProcs[i].pid == 0 && gProcs[i].state == PROC_ALIVE) {
+        why = "player already in the game";
+    }
+    if (why) {
+        fprintf(stderr, "[Referee] Rejected connection (player ID %d): %s\n", rec->playerId, why);
+        gForeignRecs++;
+        closeConn(slot);
+        return -1;
+    }
+
+    gConns[i] = gConns[slot];
+    gConns[slot].fd  = -1;
+    gConns[slot].len = 0;
+    struct epoll_event ev;
+    ev.events   = EPOLLIN;
+    ev.data.u32 = EV_TAG(EV_SOCKET, i);
+    epoll_ctl(gLoopFD, EPOLL_CTL_MOD, gConns[i].fd, &ev);
+
+    if (gProcs[i].state == PROC_DEAD) gProcs[i].state = PROC_STARTING;   // external player reconnecting
+    markReady(i);
+    return i;
+}
+
+// ----------------------------
+// handleDisconnect
+// Player i's connection closed. A process the referee started is
+// reaped through its pidfd as usual; an external player is marked
+// fallen and rejoins (next round) if it connects again.
+// ----------------------------
+static void handleDisconnect(int i) {
+    closeConn(i);
+    PlayerProc* p = &gProcs[i];
+    if (p->pid > 0 || p->state == PROC_DEAD) return;
+
+    p->state    = PROC_DEAD;
+    p->crashes++;
+    p->diedAtNs = monotonicNs();
+    gRejoinPending[i] = 0;
+    pthread_mutex_lock(&gStateLock);
+    setPlayerFallen(&gPlayers, i, 1);
+    gPlayers.energy[i] = 0;
+    markSceneDirty(SCENE_PLAYERS);
+    pthread_mutex_unlock(&gStateLock);
+    printf("[Referee] Player %d disconnected; it rejoins if it connects again\n", gPlayers.id[i]);
+}
+
+// ----------------------------
+// drainConn
+// Read everything queued on a connection and handle each complete
+// record (a TCP read may end mid-record; the rest is kept). Returns
+// the number of fresh reports for the current tick.
+// ----------------------------
+static int drainConn(int slot) {
+    int fresh = 0;
+    for (;;) {
+        SocketConn* c = &gConns[slot];
+        if (c->fd == -1) return fresh;
+        size_t room = sizeof(c->buf) - c->len;
+        ssize_t n = read(c->fd, c->buf + c->len, room);
+        gReportReads++;
+        if (n == -1 && errno == EINTR) continue;
+        if (n == -1 && (errno == EAGAIN || errno == EWOULDBLOCK)) return fresh;
+        if (n <= 0) {
+            if (slot < NUM_PLAYERS) {
+                handleDisconnect(slot);
+            } else {
+                closeConn(slot);
+            }
+            return fresh;
+        }
+        c->len += (size_t)n;
+
+        size_t used = 0;
+        while (c->len - used >= sizeof(ReportRecord)) {
+            ReportRecord rec;
+            memcpy(&rec, c->buf + used, sizeof(rec));
+            used += sizeof(rec);
+            if (slot >= NUM_PLAYERS) {
+                int i = identifyConn(slot, &rec);
+                if (i < 0) return fresh;
+                // The rest of the buffer moved with the connection
+                SocketConn* moved = &gConns[i];
+                memmove(moved->buf, moved->buf + used, moved->len - used);
+                moved->len -= used;
+                return fresh + drainConn(i);
+            }
+            if (rec.playerId != gPlayers.id[slot]) {
+                gForeignRecs++;
+            } else {
+                fresh += acceptRecord(slot, &rec);
+            }
+        }
+        memmove(c->buf, c->buf + used, c->len - used);
+        c->len -= used;
+        if ((size_t)n < room) return fresh;   // short read: the socket is empty
+    }
+}
+
+// ----------------------------
+// flushCommands
+// One CommandRecord per connected player with everything staged for
+// this tick. Returns the number of records sent.
+// ----------------------------
+static int flushCommands(uint32_t seq) {
+    int sent = 0;
+    for (int i = 0; i < NUM_PLAYERS; i++) {
+        CommandRecord* cmd = &gPendingCmd[i];
+        if (cmd->flags == 0) continue;
+        cmd->seq = seq;
+        if (gConns[i].fd == -1 || gProcs[i].state != PROC_ALIVE) {
+            gCommandDrops++;
+            memset(cmd, 0, sizeof(*cmd));
+            continue;
+        }
+        // Flow starts go first: the player may handle the record before send() returns
+        int flows[3] = { -1, -1, -1 };
+        if (cmd->flags & CMD_START_PULLING) flows[0] = traceFlowStart(TRACE_FLOW_START, seq, gPlayers.id[i]);
+        if (cmd->flags & CMD_SET_FACTOR)    flows[1] = traceFlowStart(TRACE_FLOW_READY, seq, gPlayers.id[i]);
+        if (cmd->flags & CMD_REPORT)        flows[2] = traceFlowStart(TRACE_FLOW_REPORT, seq, gPlayers.id[i]);
+        ssize_t n = send(gConns[i].fd, cmd, sizeof(*cmd), MSG_NOSIGNAL | MSG_DONTWAIT);
+        if (n == (ssize_t)sizeof(*cmd)) {
+            gCommandsSent++;
+            sent++;
+        } else {
+            for (int f = 0; f < 3; f++) traceCancel(flows[f]);
+            gCommandDrops++;   // a dead connection is noticed by drainConn
+            if (n > 0) {
+                // Part of a record is in the stream: every later record
+                // would be misaligned, so give up on this connection.
+                fprintf(stderr, "[Referee] Player %d: short command write, closing its connection\n",
+                        gPlayers.id[i]);
+                handleDisconnect(i);
+            }
+        }
+        memset(cmd, 0, sizeof(*cmd));
+    }
+    return sent;
+}
+
+// ----------------------------
+// waitConns
+// gatherReports for sockets: wait up to *timeout for any player
+// connection and drain the ready ones. Returns fresh reports.
+// ----------------------------
+static int waitConns(const struct timespec* timeout) {
+    struct pollfd fds[NUM_PLAYERS];
+    int slots[NUM_PLAYERS];
+    int n = 0;
+    for (int i = 0; i < NUM_PLAYERS; i++) {
+        if (gConns[i].fd == -1) continue;
+        fds[n].fd     = gConns[i].fd;
+        fds[n].events = POLLIN;
+        slots[n++]    = i;
+    }
+    if (ppoll(fds, n, timeout, NULL) == -1 && errno != EINTR) {
+        perror("ppoll");
+        return 0;
+    }
+    int fresh = 0;
+    for (int k = 0; k < n; k++) {
+        if (fds[k].revents) fresh += drainConn(slots[k]);
+    }
+    return fresh;
+}
+
+// ----------------------------
+// handlePlayerExit
+// Reap player i, mark it fallen right away (so no tick waits on it)
+// and start a replacement unless it has crashed too often.
+// ----------------------------
+static void handlePlayerExit(int epfd, int i) {
+    PlayerProc* p = &gProcs[i];
+    if (p->state == PROC_DEAD) return;
+
+    int status = 0;
+    pid_t r = waitpid(p->pid, &status, WNOHANG);
+    if (r == 0) return;  // still running (stale event)
+
+    if (r == -1) {
+        perror("waitpid");
+    } else if (WIFSIGNALED(status)) {
+        printf("[Referee] Player %d (pid %d) killed by signal %d\n", gPlayers.id[i], p->pid, WTERMSIG(status));
+    } else {
+        printf("[Referee] Player %d (pid %d) exited with status %d\n", gPlayers.id[i], p->pid, WEXITSTATUS(status));
+    }
+
+    if (p->pidfd != -1) {
+        epoll_ctl(epfd, EPOLL_CTL_DEL, p->pidfd, NULL);
+        close(p->pidfd);
+        p->pidfd = -1;
+    }
+    if (p->factorFD != -1) close(p->factorFD);
+    closeConn(i);
+    p->state    = PROC_DEAD;
+    p->pid      = 0;
+    p->crashes++;
+    p->diedAtNs = monotonicNs();
+    gRejoinPending[i] = 0;
+
+    pthread_mutex_lock(&gStateLock);
+    setPlayerFallen(&gPlayers, i, 1);
+    gPlayers.energy[i] = 0;
+    markSceneDirty(SCENE_PLAYERS);
+    pthread_mutex_unlock(&gStateLock);
+
+    if (p->crashes > gConfig.maxRespawns) {
+        printf("[Referee] Player %d crashed %d times; staying fallen\n", gPlayers.id[i], p->crashes);
+        return;
+    }
+    spawnPlayer(epfd, i);
+}
+
+// ----------------------------
+// listenForPlayers
+// Socket transport: open the listening socket and watch it in the
+// referee loop, which accepts replacements and reconnects later on.
+// ----------------------------
+static void listenForPlayers(int epfd) {
+    if (parseTransportAddr(gConfig.listenAddr, &gListenAddr) == -1) exit(1);
+    gListenFD = listenTransport(&gListenAddr);
+    if (gListenFD == -1) exit(1);
+    gLoopFD = epfd;
+    initConns();
+    watchFD(epfd, gListenFD, EV_TAG(EV_LISTEN, 0));
+    printf("[Referee] Listening for players on %s\n", gConfig.listenAddr);
+}
+
+// ----------------------------
+// spawnPlayers
+// Fork all players, then wait (bounded) for every ready handshake
+// so the first tick never races process start-up. With spawn_players
+// = 0 the players are started elsewhere and the wait has no deadline.
+// ----------------------------
+void spawnPlayers(int epfd) {
+    for (int id = 0; id < 256; id++) gIndexById[id] = -1;
+    for (int i = 0; i < NUM_PLAYERS; i++) {
+        if (gPlayers.id[i] < 0 || gPlayers.id[i] > 255) {
+            fprintf(stderr, "[Referee] Player ID %d out of range (0..255)\n", gPlayers.id[i]);
+            exit(1);
+        }
+        gIndexById[gPlayers.id[i]] = i;
+    }
+
+    if (gConfig.listenAddr) {
+        listenForPlayers(epfd);
+    }
+    for (int t = 0; t < NUM_TEAMS && !gConfig.listenAddr; t++) {
+        if (pipe2(gTeamPipe[t], O_CLOEXEC) == -1) {
+            perror("pipe report");
+            exit(1);
+        }
+        // Reads happen only after poll/epoll says data is there; never block on a stuck child.
+        fcntl(gTeamPipe[t][0], F_SETFL, fcntl(gTeamPipe[t][0], F_GETFL) | O_NONBLOCK);
+        watchFD(epfd, gTeamPipe[t][0], EV_TAG(EV_ENERGY, t));
+    }
+
+    for (int i = 0; i < NUM_PLAYERS; i++) {
+        if (!gResumeState[i].valid) gInitialEnergy[i] = gPlayers.energy[i];
+        gProcs[i].pidfd    = -1;
+        gProcs[i].factorFD = -1;
+        if (gConfig.listenAddr && !gConfig.spawnPlayers) {
+            gProcs[i].pid   = 0;
+            gProcs[i].state = PROC_STARTING;
+        } else {
+            spawnPlayer(epfd, i);
+        }
+    }
+    if (gConfig.listenAddr && !gConfig.spawnPlayers) {
+        printf("[Referee] Waiting for %d players on %s\n", NUM_PLAYERS, gConfig.listenAddr);
+    }
+
+    long long deadline = monotonicNs() + READY_TIMEOUT_NS;
+    for (;;) {
+        int starting = 0;
+        for (int i = 0; i < NUM_PLAYERS; i++) {
+            starting += (gProcs[i].state == PROC_STARTING);
+        }
+        long long remaining = deadline - monotonicNs();
+        if (starting == 0) break;
+
+        if (gConfig.listenAddr) {
+            // Handshakes arrive on connections the referee loop would
+            // accept; dispatch its events here until everyone is in.
+            if (remaining <= 0 && gConfig.spawnPlayers) break;
+            struct epoll_event evs[16];
+            int timeoutMs = gConfig.spawnPlayers ? (int)(remaining / 1000000) + 1 : -1;
+            int n = epoll_wait(epfd, evs, 16, timeoutMs);
+            if (n == -1 && errno != EINTR) break;
+            for (int k = 0; k < n; k++) {
+                handlePlayerEvent(epfd, evs[k].data.u32);
+            }
+            continue;
+        }
+        if (remaining <= 0) break;
+
+        struct pollfd fds[NUM_TEAMS];
+        for (int t = 0; t < NUM_TEAMS; t++) {
+            fds[t].fd = gTeamPipe[t][0];
+            fds[t].events = POLLIN;
+        }
+        if (poll(fds, NUM_TEAMS, (int)(remaining / 1000000) + 1) == -1 && errno != EINTR) break;
+        for (int t = 0; t < NUM_TEAMS; t++) {
+            if (fds[t].revents & POLLIN) drainTeam(t);
+        }
+    }
+
+    for (int i = 0; i < NUM_PLAYERS; i++) {
+        if (gProcs[i].state != PROC_ALIVE) {
+            fprintf(stderr, "[Referee] Player %d did not complete the ready handshake\n", gPlayers.id[i]);
+        }
+    }
+}
+
+// ----------------------------
+// stopPlayers
+// Registered with atexit: terminate and reap every child so no
+// player outlives the referee.
+// ----------------------------
+void stopPlayers(void) {
+    for (int i = 0; i < NUM_PLAYERS; i++) {
+        if (gProcs[i].pid > 0) {
+            kill(gProcs[i].pid, SIGTERM);
+        }
+    }
+    for (int i = 0; i < NUM_PLAYERS; i++) {
+        if (gProcs[i].pid > 0) {
+            waitpid(gProcs[i].pid, NULL, 0);
+            gProcs[i].pid = 0;
+        }
+    }
+    if (gListenFD != -1) {
+        for (size_t s = 0; s < sizeof(gConns) / sizeof(gConns[0]); s++) {
+            closeConn((int)s);
+        }
+        closeTransport(gListenFD, &gListenAddr);
+        gListenFD = -1;
+    }
+}
+
+// ----------------------------
+// handlePlayerEvent
+// Dispatch an EV_PIDFD / EV_ENERGY / EV_LISTEN / EV_SOCKET event from
+// the referee loop. Energy data outside a tick is a handshake, a late
+// report or a disconnect.
+// ----------------------------
+void handlePlayerEvent(int epfd, unsigned tag) {
+    int i = EV_INDEX(tag);
+    if (EV_KIND(tag) == EV_PIDFD && i >= 0 && i < NUM_PLAYERS) {
+        handlePlayerExit(epfd, i);
+    } else if (EV_KIND(tag) == EV_ENERGY && i >= 0 && i < NUM_TEAMS) {
+        drainTeam(i);
+    } else if (EV_KIND(tag) == EV_LISTEN) {
+        acceptPlayers(epfd);
+    } else if (EV_KIND(tag) == EV_SOCKET && i >= 0 && i < NUM_PLAYERS + MAX_NEW_CONNS) {
+        drainConn(i);
+    }
+}
+
+// ----------------------------
+// reapPlayers
+// Fallback when pidfds are unavailable: poll for exited children.
+// ----------------------------
+void reapPlayers(int epfd) {
+    for (int i = 0; i < NUM_PLAYERS; i++) {
+        if (gProcs[i].pid > 0 && gProcs[i].pidfd == -1 && gProcs[i].state != PROC_DEAD) {
+            handlePlayerExit(epfd, i);
+        }
+    }
+}
+
+// ----------------------------
+// signalPlayers
+// Send sig (with value attached via sigqueue) to every ready player.
+// A failed send with ESRCH means the child is gone; it is handled as
+// a crash on the spot. Returns the number of players signalled.
+// Socket transport: the signal's step is staged instead, and the
+// tick's REPORT_ENERGY sends everything as one CommandRecord each.
+// ----------------------------
+int signalPlayers(int epfd, int sig, int value) {
+    int sent = 0;
+    union sigval sv;
+    sv.sival_int = value;
+    traceBegin(TR_SIGNAL, sig);
+    if (gListenFD != -1) {
+        uint8_t flag = sig == SIGUSR2 ? CMD_START_PULLING :
+                       sig == SIGUSR1 ? CMD_SET_FACTOR : CMD_REPORT;
+        for (int i = 0; i < NUM_PLAYERS; i++) {
+            if (gProcs[i].state == PROC_ALIVE) gPendingCmd[i].flags |= flag;
+        }
+        if (flag == CMD_REPORT) sent = flushCommands((uint32_t)value);
+        traceEnd(TR_SIGNAL);
+        return sent;
+    }
+    for (int i = 0; i < NUM_PLAYERS; i++) {
+        if (gProcs[i].state != PROC_ALIVE) continue;
+        int flow = traceFlowStart(traceFlowForSignal(sig), (uint32_t)value, gPlayers.id[i]);
+        if (sigqueue(gProcs[i].pid, sig, sv) == 0) {
+            sent++;
+            continue;
+        }
+        traceCancel(flow);
+        if (errno == ESRCH) {
+            handlePlayerExit(epfd, i);
+        } else {
+            perror("sigqueue");
+        }
+    }
+    traceEnd(TR_SIGNAL);
+    return sent;
+}
+
+// ----------------------------
+// sendFactors
+// Write each ready player's new position factor and the round it is
+// for to its factor pipe, and let replacements rejoin the game now
+// that a round is starting.
+// ----------------------------
+void sendFactors(int epfd, const RoundInfo* round) {
+    (void)epfd;
+    for (int i = 0; i < NUM_PLAYERS; i++) {
+        if (gProcs[i].state != PROC_ALIVE) continue;
+        if (gRejoinPending[i]) {
+            setPlayerFallen(&gPlayers, i, 0);
+            gPlayers.energy[i] = gInitialEnergy[i];
+            gRejoinPending[i]  = 0;
+        }
+        FactorMessage msg;
+        msg.factor = playerFactor(&gPlayers, i);
+        msg.round  = *round;
+        if (gListenFD != -1) {
+            gPendingCmd[i].factor = (uint8_t)msg.factor;   // goes out with the tick's command
+            gPendingCmd[i].round  = msg.round;
+            continue;
+        }
+        if (write(gProcs[i].factorFD, &msg, sizeof(msg)) == -1) {
+            perror("write factor pipe");  // EPIPE: the pidfd reports the exit
+        } else {
+            printf("[Referee] Wrote factor %d to child %d\n", msg.factor, gPlayers.id[i]);
+        }
+    }
+}
+
+// ----------------------------
+// gatherReports
+// Wait at most timeoutNs (wall clock) for the answers to tick `seq`
+// from every ready player, draining each readable team pipe with one
+// read() per wake-up. reports[i] is the effective energy of player i, or
+// -1 if it did not answer in time. Returns the number of missing reports.
+// ----------------------------
+int gatherReports(int epfd, int reports[], uint32_t seq, long long timeoutNs) {
+    (void)epfd;
+    gCurrentSeq = seq;
+    gReportTicks++;
+    unsigned long long readsBefore = gReportReads;
+
+    int expected = 0;
+    for (int i = 0; i < NUM_PLAYERS; i++) {
+        gTickReports[i] = -1;
+        expected += (gProcs[i].state == PROC_ALIVE);
+    }
+
+    int received = 0;
+    long long deadline = monotonicNs() + timeoutNs;
+    while (received < expected) {
+        long long remaining = deadline - monotonicNs();
+        if (remaining <= 0) break;
+
+        struct timespec ts = { remaining / 1000000000LL, remaining % 1000000000LL };
+        if (gListenFD != -1) {
+            received += waitConns(&ts);
+            continue;
+        }
+
+        struct pollfd fds[NUM_TEAMS];
+        for (int t = 0; t < NUM_TEAMS; t++) {
+            fds[t].fd = gTeamPipe[t][0];
+            fds[t].events = POLLIN;
+        }
+        if (ppoll(fds, NUM_TEAMS, &ts, NULL) == -1 && errno != EINTR) {
+            perror("ppoll");
+            break;
+        }
+
+        // Teammates answer within microseconds of each other; give the rest
+        // a short window to land so one read() picks up the whole batch.
+        if (gConfig.reportCoalesceNs > 0) {
+            long long window = deadline - monotonicNs();
+            if (window > gConfig.reportCoalesceNs) window = gConfig.reportCoalesceNs;
+            if (window > 0) {
+                struct timespec nap = { 0, window };
+                nanosleep(&nap, NULL);
+                poll(fds, NUM_TEAMS, 0);   // the other team may have landed too
+            }
+        }
+        for (int t = 0; t < NUM_TEAMS; t++) {
+            if (fds[t].revents & POLLIN) received += drainTeam(t);
+        }
+    }
+
+    int missing = 0;
+    for (int i = 0; i < NUM_PLAYERS; i++) {
+        reports[i] = gTickReports[i];
+        if (gProcs[i].state == PROC_ALIVE && reports[i] < 0) missing++;
+    }
+    gLateReports += missing;
+    gTickReads += gReportReads - readsBefore;
+    return missing;
+}
+
+// ----------------------------
+// printPlayerHealth
+// Crash counts, respawn latency and report-channel statistics.
+// ----------------------------
+void printPlayerHealth(void) {
+    int totalCrashes = 0;
+    for (int i = 0; i < NUM_PLAYERS; i++) {
+        const PlayerProc* p = &gProcs[i];
+        totalCrashes += p->crashes;
+        if (p->crashes == 0) continue;
+        printf("[Referee] Player %d: crashes=%d, respawns=%d, respawn latency last=%.3f ms mean=%.3f ms max=%.3f ms\n",
+               gPlayers.id[i], p->crashes, p->respawns,
+               p->lastRespawnNs / 1e6,
+               p->respawns ? p->totalRespawnNs / 1e6 / p->respawns : 0.0,
+               p->maxRespawnNs / 1e6);
+    }
+    printf("[Referee] Player crashes=%d, late reports=%llu\n", totalCrashes, gLateReports);
+    printf("[Referee] Reports dropped: stale=%llu duplicate=%llu foreign=%llu; "
+           "report reads per tick=%.2f (+%llu outside ticks)\n",
+           gStaleReports, gDupReports, gForeignRecs,
+           gReportTicks ? (double)gTickReads / gReportTicks : 0.0, gReportReads - gTickReads);
+    if (gListenFD != -1) {
+        printf("[Referee] Socket transport: commands sent=%llu (%.2f per player per tick), dropped=%llu\n",
+               gCommandsSent,
+               gReportTicks ? (double)gCommandsSent / gReportTicks / NUM_PLAYERS : 0.0,
+               gCommandDrops);
+    }
+}
+
+// ----------------------------
+// playerReportedState
+// Energy (before the factor), factor and fallen flag from player i's
+// last accepted energy report. Returns 0 if it has not reported yet
+// (outputs untouched).
+// ----------------------------
+int playerReportedState(int i, int* energy, int* factor, int* fallen) {
+    const PlayerProcState* st = &gReportedState[i];
+    if (!st->valid || gProcs[i].state != PROC_ALIVE) return 0;
+    *energy = st->energy;
+    *factor = st->factor;
+    *fallen = st->fallen;
+    return 1;
+}
+
+int playerRosterEnergy(int i) {
+    return gInitialEnergy[i];
+}
+
+// Roster energy at the roster's precision: the referee keeps it rounded,
+// but the player process starts from the exact value (as before).
+void setPlayerRosterEnergy(int i, double energy) {
+    gRosterEnergy[i] = energy;
+}
+
+// ----------------------------
+// setPlayerResumeState
+// Before spawnPlayers: start player i with a checkpointed state
+// instead of its roster energy (see player.c --state).
+// ----------------------------
+void setPlayerResumeState(int i, int rosterEnergy, int energy, int factor, int fallen, int crashes) {
+    gInitialEnergy[i]     = rosterEnergy;
+    gResumeState[i].valid  = 1;
+    gResumeState[i].energy = energy;
+    gResumeState[i].factor = factor;
+    gResumeState[i].fallen = fallen;
+    gProcs[i].crashes      = crashes;
+}
+
+// ----------------------------
+// setPlayerStrategy
+// Before spawnPlayers: player i (and its replacements) start with
+// --strategy=<path>. The string must outlive the game.
+// ----------------------------
+void setPlayerStrategy(int i, const char* path) {
+    gStrategyFile[i] = path;
+}
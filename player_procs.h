@@ -0,0 +1,83 @@
+#ifndef PLAYER_PROCS_H
+#define PLAYER_PROCS_H
+
+/*
+  player_procs.h
+  --------------
+  Referee-side management of the player child processes:
+  spawning, signalling, gathering reports, and liveness.
+  Every child is watched through a pidfd in the referee's epoll loop;
+  a child that dies is marked fallen at once and a replacement is
+  spawned without waiting for it to come up.
+
+  With `listen` set, players talk to the referee over one stream socket
+  each (unix or tcp, see protocol.h) instead of pipes and signals, and
+  may run outside the referee's process tree (spawn_players = 0).
+*/
+
+#include "protocol.h"
+#include <stdint.h>
+#include <sys/types.h>
+
+// ============================
+// epoll tags used by the referee loop
+// (kind in the high 16 bits, player index in the low 16 bits)
+// ============================
+#define EV_TICK    1u   // tick clock timerfd
+#define EV_PIDFD   2u   // a player process exited
+#define EV_ENERGY  3u   // a team's report pipe has data outside a tick (index = team slot)
+#define EV_LISTEN  4u   // socket transport: a player is connecting
+#define EV_SOCKET  5u   // socket transport: data on a connection (index = connection slot)
+
+#define EV_TAG(kind, index) (((kind) << 16) | (unsigned)(index))
+#define EV_KIND(tag)        ((tag) >> 16)
+#define EV_INDEX(tag)       ((int)((tag) & 0xffffu))
+
+// ============================
+// PlayerProc Structure
+// - state: STARTING until the child sends a REPORT_READY record
+// - crashes / respawns and respawn latency (death -> ready handshake)
+// ============================
+typedef enum {
+    PROC_STARTING,
+    PROC_ALIVE,
+    PROC_DEAD
+} ProcState;
+
+typedef struct {
+    pid_t     pid;
+    int       pidfd;            // -1 if pidfd_open is unavailable
+    int       factorFD;         // parent write end (parent -> child)
+    ProcState state;
+    int       crashes;          // times this player's process died during the game
+    int       respawns;         // replacements that completed the handshake
+    long long diedAtNs;         // when the last death was detected
+    long long lastRespawnNs;    // death -> ready latency of the last respawn
+    long long totalRespawnNs;
+    long long maxRespawnNs;
+} PlayerProc;
+
+extern PlayerProc gProcs[];
+
+// ============================
+// Function Prototypes
+// ============================
+void spawnPlayers(int epfd);
+void stopPlayers(void);
+void handlePlayerEvent(int epfd, unsigned tag);
+void reapPlayers(int epfd);
+int  signalPlayers(int epfd, int sig, int value);
+void sendFactors(int epfd, const RoundInfo* round);
+int  gatherReports(int epfd, int reports[], uint32_t seq, long long timeoutNs);
+void printPlayerHealth(void);
+
+// Checkpoint / resume
+int  playerReportedState(int i, int* energy, int* factor, int* fallen);
+int  playerRosterEnergy(int i);
+void setPlayerResumeState(int i, int rosterEnergy, int energy, int factor, int fallen, int crashes);
+
+// Strategies (roster column 4)
+void setPlayerStrategy(int i, const char* path);
+void setPlayerRosterEnergy(int i, double energy);
+
+#endif // PLAYER_PROCS_H
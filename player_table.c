@@ -0,0 +1,163 @@
+/*
+============================
+       player_table.c
+   Hot/cold player storage used by the round logic:
+   - Allocates the parallel energy / flags / ID arrays
+   - Assigns position factors by energy rank within each team
+     (radix sort of packed energy|index keys)
+   - Sums reported energies per team in one branch-free pass
+   - Reports the memory footprint per player
+============================
+*/
+
+#include "player_table.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define SMALL_SORT   32    // insertion sort below this many keys
+#define RADIX_BITS   11
+#define RADIX_SIZE   (1u << RADIX_BITS)
+#define RADIX_PASSES 3     // 3 * 11 bits cover the 32-bit energy half of a key
+
+// ----------------------------
+// playerTableInit
+// Allocate storage for `count` players (factor 1, Team 1, not fallen).
+// Returns 0 on success, -1 on allocation failure.
+// ----------------------------
+int playerTableInit(PlayerTable* t, int count) {
+    memset(t, 0, sizeof(*t));
+    t->count   = count;
+    t->energy  = calloc(count, sizeof(int32_t));
+    t->flags   = malloc(count);
+    t->id      = calloc(count, sizeof(int32_t));
+    t->scratch = malloc(2 * (size_t)count * sizeof(uint64_t));
+    if (!t->energy || !t->flags || !t->id || !t->scratch) {
+        perror("[Referee] player table");
+        playerTableFree(t);
+        return -1;
+    }
+    memset(t->flags, 1, count);
+    return 0;
+}
+
+void playerTableFree(PlayerTable* t) {
+    free(t->energy);
+    free(t->flags);
+    free(t->id);
+    free(t->scratch);
+    memset(t, 0, sizeof(*t));
+}
+
+// ----------------------------
+// sortEnergyKeys
+// Sort keys ascending by their upper 32 bits, keeping the original order
+// of equal keys. Returns whichever of keys/tmp holds the result.
+// ----------------------------
+uint64_t* sortEnergyKeys(uint64_t* keys, uint64_t* tmp, int n) {
+    if (n <= SMALL_SORT) {
+        for (int i = 1; i < n; i++) {
+            uint64_t k = keys[i];
+            int j = i - 1;
+            while (j >= 0 && (keys[j] >> 32) > (k >> 32)) {
+                keys[j + 1] = keys[j];
+                j--;
+            }
+            keys[j + 1] = k;
+        }
+        return keys;
+    }
+
+    uint64_t* src = keys;
+    uint64_t* dst = tmp;
+    for (int pass = 0; pass < RADIX_PASSES; pass++) {
+        unsigned shift = 32 + pass * RADIX_BITS;
+        uint32_t count[RADIX_SIZE] = { 0 };
+        for (int i = 0; i < n; i++) count[(src[i] >> shift) & (RADIX_SIZE - 1)]++;
+        uint32_t pos = 0;
+        for (uint32_t d = 0; d < RADIX_SIZE; d++) {
+            uint32_t c = count[d];
+            count[d] = pos;
+            pos += c;
+        }
+        for (int i = 0; i < n; i++) dst[count[(src[i] >> shift) & (RADIX_SIZE - 1)]++] = src[i];
+        uint64_t* swap = src;
+        src = dst;
+        dst = swap;
+    }
+    return src;
+}
+
+// ----------------------------
+// assignFactors
+// Within each team, rank players by ascending energy and give the
+// lowest quartile factor 1 ... the highest quartile factor 4. With four
+// players per team this is exactly factor = rank + 1.
+// ----------------------------
+void assignFactors(PlayerTable* t) {
+    uint64_t* keys = t->scratch;
+    uint64_t* tmp  = t->scratch + t->count;
+
+    for (int team = 0; team < 2; team++) {
+        uint8_t want = team ? PF_TEAM2 : 0;
+        int n = 0;
+        for (int i = 0; i < t->count; i++) {
+            if ((t->flags[i] & PF_TEAM2) != want) continue;
+            // Flip the sign bit so signed energies order as unsigned keys
+            uint32_t e = (uint32_t)t->energy[i] ^ 0x80000000u;
+            keys[n++] = ((uint64_t)e << 32) | (uint32_t)i;
+        }
+        const uint64_t* sorted = sortEnergyKeys(keys, tmp, n);
+        for (int r = 0; r < n; r++) {
+            int i = (int)(uint32_t)sorted[r];
+            setPlayerFactor(t, i, 1 + (int)((int64_t)r * NUM_FACTORS / n));
+        }
+    }
+}
+
+// ----------------------------
+// sumTeamEnergies
+// reports[i] is the effective energy of player i this tick, or -1 if it
+// did not answer. Counted reports replace the stored energy; fallen
+// players and missing reports add nothing. Written without branches so
+// the loop vectorizes.
+// ----------------------------
+void sumTeamEnergies(PlayerTable* t, const int32_t reports[], int64_t* sum1, int64_t* sum2) {
+    int32_t* restrict       energy = t->energy;
+    const uint8_t* restrict flags  = t->flags;
+    int64_t s1 = 0, s2 = 0;
+
+    for (int i = 0; i < t->count; i++) {
+        int32_t r     = reports[i];
+        int32_t take  = -(int32_t)(((flags[i] & PF_FALLEN) == 0) & (r >= 0));  // all ones if counted
+        int32_t team2 = -(int32_t)((flags[i] & PF_TEAM2) != 0);
+        int32_t v     = r & take;
+        energy[i] = v | (energy[i] & ~take);
+        s1 += v & ~team2;
+        s2 += v & team2;
+    }
+    *sum1 = s1;
+    *sum2 = s2;
+}
+
+// ----------------------------
+// Footprint
+// ----------------------------
+size_t playerHotBytes(void) {
+    return sizeof(int32_t) + sizeof(uint8_t);
+}
+
+size_t playerColdBytes(void) {
+    return sizeof(int32_t);
+}
+
+void printPlayerFootprint(const PlayerTable* t, int rendered) {
+    size_t hot     = playerHotBytes();
+    size_t cold    = playerColdBytes();
+    size_t scratch = 2 * sizeof(uint64_t);
+    size_t render  = rendered ? sizeof(PlayerSprite) : 0;
+    size_t total   = (hot + cold + scratch + render) * (size_t)t->count;
+    printf("[Referee] Player storage: %d players, hot %zu B/player (energy + flags), "
+           "id %zu B/player, sort scratch %zu B/player, render %zu B/player%s; %.1f KiB total\n",
+           t->count, hot, cold, scratch, render, rendered ? "" : " (headless)", total / 1024.0);
+}
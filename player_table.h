@@ -0,0 +1,73 @@
+#ifndef PLAYER_TABLE_H
+#define PLAYER_TABLE_H
+
+/*
+  player_table.h
+  --------------
+  Referee-side player storage, split by access pattern.
+
+  The round logic (reordering by energy, summing team energies) only
+  touches a 32-bit energy and one packed flags byte per player, kept in
+  parallel arrays so a scan streams through 5 bytes per player. The
+  roster ID is a separate array read when talking to processes and
+  logging. Screen positions are not stored here at all: the renderer
+  keeps its own PlayerSprite array, built only when a window is open.
+
+  flags: bits 0-2 position factor (1..4)
+         bit  3   fallen
+         bit  4   team (0 = Team 1, 1 = Team 2)
+*/
+
+#include <stdint.h>
+#include <stddef.h>
+
+#define PF_FACTOR_MASK 0x07u
+#define PF_FALLEN      0x08u
+#define PF_TEAM2       0x10u
+
+#define NUM_FACTORS    4   // factors 1..4; a team is split into quartiles by energy
+
+// ============================
+// PlayerTable Structure
+// ============================
+typedef struct {
+    int      count;
+    int32_t* energy;   // hot: current energy
+    uint8_t* flags;    // hot: factor / fallen / team
+    int32_t* id;       // cold: roster ID
+    uint64_t* scratch; // sort keys for assignFactors (2 * count)
+} PlayerTable;
+
+// Render-only data, one per player, owned by the GLUT side
+typedef struct {
+    float x;
+    float y;
+} PlayerSprite;
+
+static inline int playerTeam(const PlayerTable* t, int i)   { return (t->flags[i] & PF_TEAM2) ? 2 : 1; }
+static inline int playerFactor(const PlayerTable* t, int i) { return t->flags[i] & PF_FACTOR_MASK; }
+static inline int playerFallen(const PlayerTable* t, int i) { return (t->flags[i] & PF_FALLEN) != 0; }
+
+static inline void setPlayerTeam(PlayerTable* t, int i, int team) {
+    t->flags[i] = (uint8_t)((t->flags[i] & ~PF_TEAM2) | (team == 2 ? PF_TEAM2 : 0));
+}
+static inline void setPlayerFactor(PlayerTable* t, int i, int factor) {
+    t->flags[i] = (uint8_t)((t->flags[i] & ~PF_FACTOR_MASK) | (factor & PF_FACTOR_MASK));
+}
+static inline void setPlayerFallen(PlayerTable* t, int i, int fallen) {
+    t->flags[i] = (uint8_t)((t->flags[i] & ~PF_FALLEN) | (fallen ? PF_FALLEN : 0));
+}
+
+// ============================
+// Function Prototypes
+// ============================
+int  playerTableInit(PlayerTable* t, int count);
+void playerTableFree(PlayerTable* t);
+void assignFactors(PlayerTable* t);
+uint64_t* sortEnergyKeys(uint64_t* keys, uint64_t* tmp, int n);
+void sumTeamEnergies(PlayerTable* t, const int32_t reports[], int64_t* sum1, int64_t* sum2);
+size_t playerHotBytes(void);
+size_t playerColdBytes(void);
+void printPlayerFootprint(const PlayerTable* t, int rendered);
+
+#endif // PLAYER_TABLE_H
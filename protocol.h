@@ -0,0 +1,92 @@
+#ifndef PROTOCOL_H
+#define PROTOCOL_H
+
+/*
+  protocol.h
+  ----------
+  Messages shared by the referee (parent.c) and player processes (player.c).
+
+  All players of a team write to one shared report pipe. Every message is a
+  fixed-size ReportRecord written with a single write() of at most PIPE_BUF
+  bytes, which POSIX guarantees is never interleaved with other writers, so
+  the referee can drain a whole team with one large read().
+
+  REPORT_ENERGY (SIGALRM) is sent with sigqueue(); its value is the tick
+  sequence number, which the player echoes back so stale or duplicated
+  reports can be dropped.
+
+  GET_READY hands each player a FactorMessage on its factor pipe: the new
+  position factor and the round it is for (round number and scores), which
+  player strategies (strategy.h) can take into account.
+
+  Socket transport (referee --listen, player --connect): each player has
+  one stream connection instead of the pipes and signals. The referee
+  sends one CommandRecord per player per tick, whose flags carry every
+  signal of that tick in the order the signals would arrive; players
+  answer with the same ReportRecords as on the pipes.
+*/
+
+#include <stdint.h>
+#include <limits.h>
+
+// ============================
+// ReportRecord (player -> referee)
+// ============================
+typedef enum {
+    REPORT_READY  = 1,   // sent once after the signal handlers are installed
+    REPORT_ENERGY = 2    // answer to REPORT_ENERGY for tick `seq`
+} ReportType;
+
+typedef struct {
+    uint8_t  type;         // ReportType
+    uint8_t  playerId;     // roster ID (not the pipe or slot index)
+    uint8_t  fallen;       // 1 if the player has fallen
+    uint8_t  factor;       // position factor the energy was multiplied by
+    uint32_t seq;          // tick sequence being answered (0 for READY)
+    int32_t  energy;       // effective energy (gEnergy * factor * effort), 0 if fallen
+    int32_t  pid;          // sender, so records from a replaced process are ignored
+    int32_t  ownEnergy;    // the player's own energy after this tick (rounded), for checkpoints
+    uint32_t pad;
+    int64_t  timestampNs;  // CLOCK_MONOTONIC when written
+} ReportRecord;
+
+_Static_assert(sizeof(ReportRecord) == 32, "ReportRecord layout changed");
+_Static_assert(sizeof(ReportRecord) <= PIPE_BUF, "ReportRecord must be written atomically");
+
+// ============================
+// FactorMessage (referee -> player, GET_READY)
+// ============================
+typedef struct {
+    uint8_t round;        // round about to start (1-based)
+    uint8_t maxRounds;
+    uint8_t scoreTeam1;   // rounds won so far
+    uint8_t scoreTeam2;
+} RoundInfo;
+
+typedef struct {
+    int32_t   factor;     // new position factor (1..4)
+    RoundInfo round;
+} FactorMessage;
+
+_Static_assert(sizeof(FactorMessage) == 8, "FactorMessage layout changed");
+
+// ============================
+// CommandRecord (referee -> player, socket transport only)
+// ============================
+typedef enum {
+    CMD_START_PULLING = 0x01,   // SIGUSR2: deplete energy
+    CMD_SET_FACTOR    = 0x02,   // SIGUSR1 + factor pipe: take `factor`
+    CMD_REPORT        = 0x04    // SIGALRM: report energy for tick `seq`
+} CommandFlags;
+
+typedef struct {
+    uint8_t   flags;    // CommandFlags, applied in the order above
+    uint8_t   factor;   // new position factor (CMD_SET_FACTOR)
+    uint16_t  pad;
+    uint32_t  seq;      // tick sequence to echo in the report
+    RoundInfo round;    // round the factor is for (CMD_SET_FACTOR)
+} CommandRecord;
+
+_Static_assert(sizeof(CommandRecord) == 12, "CommandRecord layout changed");
+
+#endif // PROTOCOL_H
@@ -0,0 +1,324 @@
+/*
+============================
+       results_query.c
+   Aggregation queries over the referee's columnar results file:
+   - Compacts the file's partial chunks, then maps it read-only and
+     walks its chunks
+   - Skips chunks whose per-column min/max cannot match the filter
+   - Scans fixed-width int32 columns in tight loops the compiler vectorizes
+   Usage: results_query <results file> <summary|winrate|roundlen|hitticks> [--roster=<hash>]
+============================
+*/
+
+#include "results_store.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#define MAX_ROSTERS 4096          // open-addressing group table (power of two)
+
+typedef struct {
+    const ResultsChunkHeader* hdr;
+    const ResultsColumnStats* stats;
+    const int32_t*            data;
+} Chunk;
+
+static Chunk* gChunks[TABLE_COUNT];
+static int    gChunkCount[TABLE_COUNT];
+
+static int     gFilterRoster = 0;
+static int32_t gRoster       = 0;
+static long    gScanned      = 0;
+static long    gSkipped      = 0;
+
+static const int32_t* column(const Chunk* c, int col) {
+    return c->data + (size_t)col * c->hdr->rows;
+}
+
+// ----------------------------
+// mapChunks
+// Index every chunk of the mapped file by table.
+// Returns -1 on a corrupt or truncated file.
+// ----------------------------
+static int mapChunks(const unsigned char* base, size_t size) {
+    int capacity[TABLE_COUNT] = { 0 };
+
+    size_t off = 0;
+    while (off + sizeof(ResultsChunkHeader) <= size) {
+        const ResultsChunkHeader* hdr = (const ResultsChunkHeader*)(base + off);
+        if (!resultsChunkValid(hdr, size - off)) {
+            fprintf(stderr, "Corrupt chunk at offset %zu\n", off);
+            return -1;
+        }
+        int t = hdr->table;
+        if (gChunkCount[t] == capacity[t]) {
+            capacity[t] = capacity[t] ? capacity[t] * 2 : 64;
+            gChunks[t] = realloc(gChunks[t], capacity[t] * sizeof(Chunk));
+            if (!gChunks[t]) {
+                perror("realloc");
+                return -1;
+            }
+        }
+        Chunk* c = &gChunks[t][gChunkCount[t]++];
+        c->hdr   = hdr;
+        c->stats = (const ResultsColumnStats*)(hdr + 1);
+        c->data  = (const int32_t*)(c->stats + hdr->cols);
+        off += hdr->bytes;
+    }
+    return 0;
+}
+
+// ----------------------------
+// chunkMatches
+// Min/max pruning for the --roster filter.
+// ----------------------------
+static int chunkMatches(const Chunk* c, int rosterCol) {
+    if (gFilterRoster &&
+        (gRoster < c->stats[rosterCol].min || gRoster > c->stats[rosterCol].max)) {
+        gSkipped++;
+        return 0;
+    }
+    gScanned++;
+    return 1;
+}
+
+// ============================
+// Column kernels (branch-free, auto-vectorized at -O2/-O3)
+// ============================
+static int64_t sumColumn(const int32_t* restrict col, uint32_t n) {
+    int64_t sum = 0;
+    for (uint32_t i = 0; i < n; i++) sum += col[i];
+    return sum;
+}
+
+static uint32_t countEqual(const int32_t* restrict col, uint32_t n, int32_t value) {
+    uint32_t count = 0;
+    for (uint32_t i = 0; i < n; i++) count += (col[i] == value);
+    return count;
+}
+
+static int64_t sumWhereEqual(const int32_t* restrict col, const int32_t* restrict key,
+                             uint32_t n, int32_t value) {
+    int64_t sum = 0;
+    for (uint32_t i = 0; i < n; i++) sum += (key[i] == value) ? col[i] : 0;
+    return sum;
+}
+
+// ============================
+// Roster groups
+// ============================
+typedef struct {
+    int32_t roster;
+    int     used;
+    long    games, wins1, wins2, rounds;
+} Group;
+
+static Group gGroups[MAX_ROSTERS];
+
+// Exits if the file holds more than MAX_ROSTERS distinct rosters.
+static Group* groupFor(int32_t roster) {
+    uint32_t h = ((uint32_t)roster * 2654435761u) & (MAX_ROSTERS - 1);
+    int probes = 0;
+    while (gGroups[h].used && gGroups[h].roster != roster) {
+        if (++probes == MAX_ROSTERS) {
+            fprintf(stderr, "Too many rosters: the group table holds %d\n",
+                    MAX_ROSTERS);
+            exit(EXIT_FAILURE);
+        }
+        h = (h + 1) & (MAX_ROSTERS - 1);
+    }
+    gGroups[h].used   = 1;
+    gGroups[h].roster = roster;
+    return &gGroups[h];
+}
+
+// ----------------------------
+// querySummary
+// ----------------------------
+static void querySummary(void) {
+    for (int t = 0; t < TABLE_COUNT; t++) {
+        long rows = 0;
+        for (int k = 0; k < gChunkCount[t]; k++) rows += gChunks[t][k].hdr->rows;
+        printf("%-7s %10ld rows in %d chunks\n", gResultsTableNames[t], rows, gChunkCount[t]);
+    }
+}
+
+// ----------------------------
+// queryWinRate
+// Win rate by roster. Chunks holding a single roster (the common case:
+// one sweep point per referee) are counted with whole-column kernels.
+// ----------------------------
+static void queryWinRate(void) {
+    for (int k = 0; k < gChunkCount[TABLE_GAMES]; k++) {
+        const Chunk* c = &gChunks[TABLE_GAMES][k];
+        if (!chunkMatches(c, GAME_ROSTER)) continue;
+        uint32_t n = c->hdr->rows;
+        const int32_t* roster = column(c, GAME_ROSTER);
+        const int32_t* winner = column(c, GAME_WINNER);
+        const int32_t* rounds = column(c, GAME_ROUNDS);
+
+        if (c->stats[GAME_ROSTER].min == c->stats[GAME_ROSTER].max) {
+            Group* g = groupFor(roster[0]);
+            g->games  += n;
+            g->wins1  += countEqual(winner, n, 1);
+            g->wins2  += countEqual(winner, n, 2);
+            g->rounds += sumColumn(rounds, n);
+        } else {
+            for (uint32_t r = 0; r < n; r++) {
+                Group* g = groupFor(roster[r]);
+                g->games++;
+                g->wins1  += (winner[r] == 1);
+                g->wins2  += (winner[r] == 2);
+                g->rounds += rounds[r];
+            }
+        }
+    }
+
+    printf("%-12s %8s %8s %8s %8s %12s\n", "roster", "games", "T1 win", "T2 win", "tie", "rounds/game");
+    for (int h = 0; h < MAX_ROSTERS; h++) {
+        const Group* g = &gGroups[h];
+        if (!g->used || g->games == 0) continue;
+        double games = (double)g->games;
+        printf("%-12d %8ld %7.1f%% %7.1f%% %7.1f%% %12.2f\n", g->roster, g->games,
+               100.0 * g->wins1 / games, 100.0 * g->wins2 / games,
+               100.0 * (g->games - g->wins1 - g->wins2) / games, g->rounds / games);
+    }
+}
+
+// ----------------------------
+// queryRoundLength
+// Mean round length in ticks, overall and split by outcome.
+// ----------------------------
+static void queryRoundLength(void) {
+    long rounds = 0, decided = 0;
+    int64_t ticks = 0, decidedTicks = 0;
+    for (int k = 0; k < gChunkCount[TABLE_ROUNDS]; k++) {
+        const Chunk* c = &gChunks[TABLE_ROUNDS][k];
+        if (!chunkMatches(c, ROUND_ROSTER)) continue;
+        uint32_t n = c->hdr->rows;
+        const int32_t* len    = column(c, ROUND_TICKS);
+        const int32_t* winner = column(c, ROUND_WINNER);
+        uint32_t undecided = countEqual(winner, n, 0);
+
+        rounds       += n;
+        ticks        += sumColumn(len, n);
+        decided      += n - undecided;
+        decidedTicks += sumColumn(len, n) - sumWhereEqual(len, winner, n, 0);
+    }
+    printf("rounds=%ld  mean length=%.2f ticks\n", rounds, rounds ? (double)ticks / rounds : 0.0);
+    printf("decided=%ld  mean length=%.2f ticks\n", decided, decided ? (double)decidedTicks / decided : 0.0);
+    printf("undecided=%ld  mean length=%.2f ticks\n", rounds - decided,
+           rounds > decided ? (double)(ticks - decidedTicks) / (rounds - decided) : 0.0);
+}
+
+// ----------------------------
+// queryHitTicks
+// Distribution of the tick at which a team reached the threshold.
+// Chunks whose hit_tick max is -1 (no decided rounds) are skipped.
+// ----------------------------
+static void queryHitTicks(void) {
+    enum { MAX_BINS = 1024 };
+    long bins[MAX_BINS] = { 0 };
+    long total = 0, overflow = 0;
+    int  maxTick = 0;
+
+    for (int k = 0; k < gChunkCount[TABLE_ROUNDS]; k++) {
+        const Chunk* c = &gChunks[TABLE_ROUNDS][k];
+        if (c->stats[ROUND_HIT_TICK].max < 0) {
+            gSkipped++;
+            continue;
+        }
+        if (!chunkMatches(c, ROUND_ROSTER)) continue;
+        uint32_t n = c->hdr->rows;
+        const int32_t* hit = column(c, ROUND_HIT_TICK);
+        for (uint32_t r = 0; r < n; r++) {
+            int32_t t = hit[r];
+            if (t < 0) continue;
+            if (t >= MAX_BINS) {
+                overflow++;
+                continue;
+            }
+            bins[t]++;
+            if (t > maxTick) maxTick = t;
+        }
+    }
+
+    for (int t = 0; t <= maxTick; t++) total += bins[t];
+    total += overflow;
+    printf("%6s %10s %8s\n", "tick", "rounds", "share");
+    for (int t = 0; t <= maxTick; t++) {
+        if (!bins[t]) continue;
+        printf("%6d %10ld %7.1f%%\n", t, bins[t], 100.0 * bins[t] / total);
+    }
+    if (overflow) printf(">=%4d %10ld\n", MAX_BINS, overflow);
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 3) {
+        fprintf(stderr, "Usage: %s <results file> <summary|winrate|roundlen|hitticks> [--roster=<hash>]\n", argv[0]);
+        exit(EXIT_FAILURE);
+    }
+    for (int i = 3; i < argc; i++) {
+        if (strncmp(argv[i], "--roster=", 9) == 0) {
+            gFilterRoster = 1;
+            gRoster = (int32_t)strtol(argv[i] + 9, NULL, 0);
+        } else {
+            fprintf(stderr, "Unknown option %s\n", argv[i]);
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    // Referees flush a partial chunk per table at every game over;
+    // merge them first so min/max skipping and the column scans see
+    // full chunks. A file we cannot rewrite is queried as it is.
+    int before, after;
+    if (compactResultsStore(argv[1], &before, &after) == 0 && after < before) {
+        printf("(compacted %d chunks into %d)\n", before, after);
+    }
+
+    int fd = open(argv[1], O_RDONLY);
+    if (fd == -1) {
+        perror("open results file");
+        exit(EXIT_FAILURE);
+    }
+    struct stat st;
+    if (fstat(fd, &st) == -1) {
+        perror("fstat");
+        exit(EXIT_FAILURE);
+    }
+    if (st.st_size == 0) {
+        printf("(empty)\n");
+        return 0;
+    }
+    const unsigned char* base = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (base == MAP_FAILED) {
+        perror("mmap");
+        exit(EXIT_FAILURE);
+    }
+    close(fd);
+    if (mapChunks(base, st.st_size) == -1) exit(EXIT_FAILURE);
+
+    const char* query = argv[2];
+    if (strcmp(query, "summary") == 0) {
+        querySummary();
+    } else if (strcmp(query, "winrate") == 0) {
+        queryWinRate();
+    } else if (strcmp(query, "roundlen") == 0) {
+        queryRoundLength();
+    } else if (strcmp(query, "hitticks") == 0) {
+        queryHitTicks();
+    } else {
+        fprintf(stderr, "Unknown query %s\n", query);
+        exit(EXIT_FAILURE);
+    }
+    if (gScanned || gSkipped) {
+        printf("(chunks scanned=%ld, skipped by min/max=%ld)\n", gScanned, gSkipped);
+    }
+
+    munmap((void*)base, st.st_size);
+    return 0;
+}
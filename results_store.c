@@ -0,0 +1,364 @@
+/*
+============================
+       results_store.c
+   Columnar results writer:
+   - Buffers rows per table, column by column
+   - Writes full chunks (with per-column min/max) in one O_APPEND write,
+     padded to 8 bytes, under an exclusive flock
+   - Flushes partial chunks on close
+   - Compacts a file's partial chunks into full ones
+============================
+*/
+
+#include "results_store.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/file.h>
+#include <sys/stat.h>
+
+const int gResultsTableCols[TABLE_COUNT] = { TICK_COLS, ROUND_COLS, GAME_COLS };
+const char* gResultsTableNames[TABLE_COUNT] = { "ticks", "rounds", "games" };
+
+// Column-major row buffer for one table
+typedef struct {
+    int32_t  data[ROUND_COLS][RESULTS_CHUNK_ROWS];  // ROUND_COLS is the widest table
+    uint32_t rows;
+} TableBuffer;
+
+static int          gResultsFD   = -1;
+static char*        gResultsPath = NULL;   // reopened if compaction replaced the file
+static TableBuffer* gBuffers     = NULL;
+
+// ----------------------------
+// fnv1a64
+// Small stable hash used for roster and cache keys.
+// ----------------------------
+uint64_t fnv1a64(const void* data, size_t len, uint64_t hash) {
+    const unsigned char* p = (const unsigned char*)data;
+    for (size_t i = 0; i < len; i++) {
+        hash ^= p[i];
+        hash *= 0x100000001b3ull;
+    }
+    return hash;
+}
+
+// ----------------------------
+// openResultsStore
+// Open (or create) the results file for appending.
+// Returns 0 on success, -1 on error.
+// ----------------------------
+int openResultsStore(const char* path) {
+    gResultsFD = open(path, O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+    if (gResultsFD == -1) {
+        perror("[Referee] open results store");
+        return -1;
+    }
+    gResultsPath = strdup(path);
+    gBuffers = calloc(TABLE_COUNT, sizeof(TableBuffer));
+    if (!gBuffers || !gResultsPath) {
+        perror("[Referee] results buffers");
+        close(gResultsFD);
+        gResultsFD = -1;
+        free(gResultsPath);
+        gResultsPath = NULL;
+        return -1;
+    }
+    return 0;
+}
+
+int resultsStoreOpen(void) {
+    return gResultsFD != -1;
+}
+
+// ----------------------------
+// writeChunk
+// Serialize a table's buffered rows as one chunk, padded to a multiple
+// of 8 bytes so every header in the file stays 8-byte aligned, and
+// write it to fd in one write. Empties buf.
+// Returns 0 on success (or nothing to write), -1 on error.
+// ----------------------------
+static int writeChunk(int fd, ResultsTable table, TableBuffer* buf) {
+    uint32_t rows = buf->rows;
+    uint32_t cols = (uint32_t)gResultsTableCols[table];
+    if (rows == 0) return 0;
+    buf->rows = 0;
+
+    size_t used  = sizeof(ResultsChunkHeader)
+                 + cols * sizeof(ResultsColumnStats)
+                 + (size_t)cols * rows * sizeof(int32_t);
+    size_t bytes = (used + RESULTS_CHUNK_ALIGN - 1) & ~(size_t)(RESULTS_CHUNK_ALIGN - 1);
+    unsigned char* out = calloc(1, bytes);
+    if (!out) {
+        perror("[Referee] results chunk");
+        return -1;
+    }
+
+    ResultsChunkHeader* hdr = (ResultsChunkHeader*)out;
+    hdr->magic   = RESULTS_MAGIC;
+    hdr->version = RESULTS_VERSION;
+    hdr->table   = (uint16_t)table;
+    hdr->rows    = rows;
+    hdr->cols    = cols;
+    hdr->bytes   = bytes;
+
+    ResultsColumnStats* stats = (ResultsColumnStats*)(hdr + 1);
+    int32_t* columns = (int32_t*)(stats + cols);
+    for (uint32_t c = 0; c < cols; c++) {
+        const int32_t* col = buf->data[c];
+        int32_t lo = col[0], hi = col[0];
+        for (uint32_t r = 1; r < rows; r++) {
+            if (col[r] < lo) lo = col[r];
+            if (col[r] > hi) hi = col[r];
+        }
+        stats[c].min = lo;
+        stats[c].max = hi;
+        memcpy(columns + (size_t)c * rows, col, rows * sizeof(int32_t));
+    }
+
+    // One write per chunk: O_APPEND keeps concurrent writers from interleaving.
+    ssize_t n;
+    do {
+        n = write(fd, out, bytes);
+    } while (n == -1 && errno == EINTR);
+    free(out);
+    if (n != (ssize_t)bytes) {
+        perror("[Referee] write results chunk");
+        return -1;
+    }
+    return 0;
+}
+
+// ----------------------------
+// lockResultsFile
+// Take the exclusive lock that compaction also takes. If a compaction
+// replaced the file meanwhile, our descriptor points at the old copy:
+// reopen the path and lock that instead.
+// Returns 0 with the lock held, -1 on error (written unlocked).
+// ----------------------------
+static int lockResultsFile(void) {
+    for (;;) {
+        if (flock(gResultsFD, LOCK_EX) == -1) return -1;
+        struct stat mine, current;
+        if (fstat(gResultsFD, &mine) == -1 || stat(gResultsPath, &current) == -1) return -1;
+        if (mine.st_dev == current.st_dev && mine.st_ino == current.st_ino) return 0;
+
+        int fd = open(gResultsPath, O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+        if (fd == -1) return -1;
+        close(gResultsFD);   // drops the lock on the old copy
+        gResultsFD = fd;
+    }
+}
+
+static void appendChunk(ResultsTable table) {
+    if (gBuffers[table].rows == 0) return;
+    int locked = lockResultsFile() == 0;
+    writeChunk(gResultsFD, table, &gBuffers[table]);
+    if (locked) flock(gResultsFD, LOCK_UN);
+}
+
+// ----------------------------
+// resultsAppend
+// Buffer one row (gResultsTableCols[table] values); a full buffer
+// is written out as a chunk.
+// ----------------------------
+void resultsAppend(ResultsTable table, const int32_t row[]) {
+    if (gResultsFD == -1) return;
+    TableBuffer* buf = &gBuffers[table];
+    for (int c = 0; c < gResultsTableCols[table]; c++) {
+        buf->data[c][buf->rows] = row[c];
+    }
+    if (++buf->rows == RESULTS_CHUNK_ROWS) {
+        appendChunk(table);
+    }
+}
+
+// ----------------------------
+// flushResultsStore
+// Write out partially filled chunks.
+// ----------------------------
+void flushResultsStore(void) {
+    if (gResultsFD == -1) return;
+    for (int t = 0; t < TABLE_COUNT; t++) {
+        appendChunk((ResultsTable)t);
+    }
+}
+
+// ----------------------------
+// closeResultsStore
+// Flush and close; safe to call more than once.
+// ----------------------------
+void closeResultsStore(void) {
+    if (gResultsFD == -1) return;
+    flushResultsStore();
+    close(gResultsFD);
+    gResultsFD = -1;
+    free(gResultsPath);
+    gResultsPath = NULL;
+    free(gBuffers);
+    gBuffers = NULL;
+}
+
+// ----------------------------
+// resultsChunkValid
+// Check a chunk header against the `avail` bytes left in the file: a
+// known table and version, and a size that covers the header, the
+// column stats and rows*cols values (so `bytes` is never 0 and readers
+// never index past the chunk), rounded to RESULTS_CHUNK_ALIGN so the
+// next header is aligned. Returns 1 if valid, 0 if corrupt.
+// ----------------------------
+int resultsChunkValid(const ResultsChunkHeader* hdr, size_t avail) {
+    if (hdr->magic != RESULTS_MAGIC || hdr->version != RESULTS_VERSION ||
+        hdr->table >= TABLE_COUNT || hdr->cols != (uint32_t)gResultsTableCols[hdr->table] ||
+        hdr->rows > RESULTS_CHUNK_ROWS || hdr->bytes % RESULTS_CHUNK_ALIGN != 0) {
+        return 0;
+    }
+    uint64_t need = sizeof(ResultsChunkHeader) + hdr->cols * sizeof(ResultsColumnStats) +
+                    (uint64_t)hdr->rows * hdr->cols * sizeof(int32_t);
+    return hdr->bytes >= need && hdr->bytes <= avail;
+}
+
+// ----------------------------
+// readWholeFile
+// malloc'd copy of an open file (8-byte aligned, like every chunk).
+// Returns NULL if the file is empty or cannot be read.
+// ----------------------------
+static unsigned char* readWholeFile(int fd, size_t* size) {
+    struct stat st;
+    if (fstat(fd, &st) == -1 || st.st_size <= 0) return NULL;
+    unsigned char* data = malloc(st.st_size);
+    if (!data) return NULL;
+    size_t got = 0;
+    while (got < (size_t)st.st_size) {
+        ssize_t n = pread(fd, data + got, st.st_size - got, got);
+        if (n <= 0) {
+            if (n == -1 && errno == EINTR) continue;
+            free(data);
+            return NULL;
+        }
+        got += n;
+    }
+    *size = got;
+    return data;
+}
+
+// ----------------------------
+// resultsLastGame
+// Copy the last games-table row of a results file into row[GAME_COLS].
+// Returns 0 on success, -1 if the file is unreadable or holds no game.
+// ----------------------------
+int resultsLastGame(const char* path, int32_t row[]) {
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd == -1) return -1;
+    size_t size;
+    unsigned char* data = readWholeFile(fd, &size);
+    close(fd);
+    if (!data) return -1;
+
+    int found = -1;
+    size_t off = 0;
+    while (off + sizeof(ResultsChunkHeader) <= size) {
+        const ResultsChunkHeader* hdr = (const ResultsChunkHeader*)(data + off);
+        if (!resultsChunkValid(hdr, size - off)) break;   // stop at the first corrupt chunk
+        if (hdr->table == TABLE_GAMES && hdr->rows > 0) {
+            const int32_t* columns = (const int32_t*)((const ResultsColumnStats*)(hdr + 1) + hdr->cols);
+            for (int c = 0; c < GAME_COLS; c++) {
+                row[c] = columns[(size_t)c * hdr->rows + hdr->rows - 1];
+            }
+            found = 0;
+        }
+        off += hdr->bytes;
+    }
+    free(data);
+    return found;
+}
+
+// ----------------------------
+// compactResultsStore
+// Every referee flushes its partial chunks at game over, so a file fed
+// by many games holds mostly tiny chunks. Rewrite each table's rows, in
+// order, as full RESULTS_CHUNK_ROWS chunks (the last one partial) into
+// <path>.compact and rename it over path. The exclusive flock keeps
+// referees from appending meanwhile; they reopen the new file after.
+// *before / *after get the chunk counts (equal if nothing was merged).
+// Returns 0 on success or nothing to do, -1 on error or a corrupt file.
+// ----------------------------
+int compactResultsStore(const char* path, int* before, int* after) {
+    *before = *after = 0;
+    int fd;
+    for (;;) {
+        fd = open(path, O_RDONLY | O_CLOEXEC);
+        if (fd == -1) return -1;
+        if (flock(fd, LOCK_EX) == -1) {
+            close(fd);
+            return -1;
+        }
+        // Another compaction may have replaced the file before we locked it
+        struct stat mine, current;
+        if (fstat(fd, &mine) == 0 && stat(path, &current) == 0 &&
+            mine.st_dev == current.st_dev && mine.st_ino == current.st_ino) break;
+        close(fd);
+    }
+
+    size_t size = 0;
+    unsigned char* data = readWholeFile(fd, &size);
+    int partial[TABLE_COUNT] = { 0 };
+    int merge = 0, result = 0;
+    for (size_t off = 0; data && off < size; ) {
+        const ResultsChunkHeader* hdr = (const ResultsChunkHeader*)(data + off);
+        if (size - off < sizeof(*hdr) || !resultsChunkValid(hdr, size - off)) {
+            fprintf(stderr, "%s: corrupt chunk at offset %zu, not compacting\n", path, off);
+            result = -1;
+            break;
+        }
+        (*before)++;
+        if (hdr->rows < RESULTS_CHUNK_ROWS && ++partial[hdr->table] > 1) merge = 1;
+        off += hdr->bytes;
+    }
+    *after = *before;
+
+    TableBuffer* buf = (merge && result == 0) ? malloc(sizeof(TableBuffer)) : NULL;
+    if (buf) {
+        char tmp[4096];
+        snprintf(tmp, sizeof(tmp), "%s.compact", path);
+        int out = open(tmp, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+        result = out == -1 ? -1 : 0;
+        *after = 0;
+        for (int t = 0; t < TABLE_COUNT && result == 0; t++) {
+            buf->rows = 0;
+            for (size_t off = 0; off < size && result == 0; ) {
+                const ResultsChunkHeader* hdr = (const ResultsChunkHeader*)(data + off);
+                off += hdr->bytes;
+                if (hdr->table != t) continue;
+                const int32_t* columns = (const int32_t*)((const ResultsColumnStats*)(hdr + 1) + hdr->cols);
+                for (uint32_t r = 0; r < hdr->rows && result == 0; r++) {
+                    for (uint32_t c = 0; c < hdr->cols; c++) {
+                        buf->data[c][buf->rows] = columns[(size_t)c * hdr->rows + r];
+                    }
+                    if (++buf->rows == RESULTS_CHUNK_ROWS) {
+                        result = writeChunk(out, (ResultsTable)t, buf);
+                        (*after)++;
+                    }
+                }
+            }
+            if (result == 0 && buf->rows > 0) {
+                result = writeChunk(out, (ResultsTable)t, buf);
+                (*after)++;
+            }
+        }
+        if (out != -1 && (fsync(out) == -1 || close(out) == -1)) result = -1;
+        if (result == 0 && rename(tmp, path) == -1) result = -1;
+        if (result == -1) {
+            perror("compact results");
+            unlink(tmp);
+            *after = *before;
+        }
+        free(buf);
+    }
+    free(data);
+    close(fd);   // releases the lock
+    return result;
+}
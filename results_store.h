@@ -0,0 +1,97 @@
+#ifndef RESULTS_STORE_H
+#define RESULTS_STORE_H
+
+/*
+  results_store.h
+  ---------------
+  Append-only columnar file of game results, written by the referee
+  and scanned by results_query.
+
+  The file is a sequence of self-describing chunks. Each chunk holds
+  up to RESULTS_CHUNK_ROWS rows of one table, stored column by column
+  as fixed-width int32 values, preceded by a per-column min/max so a
+  reader can skip whole chunks without touching their data:
+
+    ResultsChunkHeader
+    ResultsColumnStats[cols]
+    int32_t column0[rows], column1[rows], ...
+
+  Chunks are written with a single O_APPEND write under an exclusive
+  flock, so several referees (e.g. a parameter sweep) can share one
+  file. Each referee flushes its partial chunks at game over;
+  compactResultsStore (run by results_query) merges them into full
+  chunks so min/max skipping and column scans stay effective.
+*/
+
+#include <stdint.h>
+#include <stddef.h>
+
+#define RESULTS_MAGIC       0x4b435052u  // "RPCK"
+#define RESULTS_VERSION     2        // 2: chunks padded to RESULTS_CHUNK_ALIGN
+#define RESULTS_CHUNK_ROWS  4096
+#define RESULTS_CHUNK_ALIGN 8        // every chunk (and so every header) is 8-byte aligned
+
+// ============================
+// Tables and their columns
+// ============================
+typedef enum {
+    TABLE_TICKS  = 0,   // one row per tick: team sum trajectories
+    TABLE_ROUNDS = 1,   // one row per round
+    TABLE_GAMES  = 2,   // one row per game
+    TABLE_COUNT
+} ResultsTable;
+
+enum { TICK_GAME, TICK_ROUND, TICK_TICK, TICK_SUM1, TICK_SUM2, TICK_COLS };
+
+enum {
+    ROUND_GAME, ROUND_ROSTER, ROUND_ROUND, ROUND_WINNER,
+    ROUND_TICKS,      // round length in ticks
+    ROUND_HIT_TICK,   // tick at which a team reached the threshold, -1 if none
+    ROUND_SUM1, ROUND_SUM2, ROUND_PEAK1, ROUND_PEAK2,
+    ROUND_FACTORS,    // factor of roster slot i in bits 4i..4i+3
+    ROUND_COLS
+};
+
+enum {
+    GAME_GAME, GAME_ROSTER, GAME_ROUNDS,
+    GAME_WINNER,      // team with more rounds won, 0 on a tie
+    GAME_SCORE1, GAME_SCORE2, GAME_TICKS,
+    GAME_COLS
+};
+
+// ============================
+// On-disk chunk layout
+// ============================
+typedef struct {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t table;
+    uint32_t rows;
+    uint32_t cols;
+    uint64_t bytes;     // whole chunk, header included
+} ResultsChunkHeader;
+
+typedef struct {
+    int32_t min;
+    int32_t max;
+} ResultsColumnStats;
+
+// ============================
+// Function Prototypes
+// ============================
+extern const int   gResultsTableCols[TABLE_COUNT];
+extern const char* gResultsTableNames[TABLE_COUNT];
+
+uint64_t fnv1a64(const void* data, size_t len, uint64_t hash);
+#define FNV1A64_INIT 0xcbf29ce484222325ull
+
+int  openResultsStore(const char* path);
+int  resultsStoreOpen(void);
+void resultsAppend(ResultsTable table, const int32_t row[]);
+void flushResultsStore(void);
+void closeResultsStore(void);
+int  resultsLastGame(const char* path, int32_t row[]);
+int  resultsChunkValid(const ResultsChunkHeader* hdr, size_t avail);
+int  compactResultsStore(const char* path, int* before, int* after);
+
+#endif // RESULTS_STORE_H
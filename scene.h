@@ -0,0 +1,38 @@
+#ifndef SCENE_H
+#define SCENE_H
+
+/*
+  scene.h
+  -------
+  Layout of the referee's window (parent.c), in its 800x600 scene
+  coordinates. The arena (arena.c) draws every tile from the same
+  numbers, so a tile always looks like a shrunken main window.
+*/
+
+#define SCENE_WIDTH      800.0f
+#define SCENE_HEIGHT     600.0f
+#define SCENE_Y          300.0f   // height of the rope and the players
+
+// Rope: a straight line of nodes before any shift
+#define ROPE_NODES       10
+#define ROPE_LENGTH      350.0f
+#define ROPE_START_X     220.0f
+
+// Rope shift per unit of team-sum difference (sum2 - sum1), and the
+// screen offset of players and rope ends per unit of rope shift
+#define ROPE_SHIFT_PER_SUM 0.08f
+#define ROPE_SHIFT_SCALE   0.05f
+
+// Players: Team 1 from the left edge inwards, Team 2 from the right
+#define TEAM1_START_X    50.0f
+#define TEAM2_START_X    750.0f
+#define PLAYER_SPACING   50.0f
+#define PLAYER_SIZE      10.0f    // half-width of a player's shape
+#define FALLEN_SCALE     0.7f     // fallen players are drawn this much smaller
+
+// Player color by energy: green / orange / yellow at or above, else black
+#define ENERGY_GREEN     250
+#define ENERGY_ORANGE    200
+#define ENERGY_YELLOW    150
+
+#endif // SCENE_H
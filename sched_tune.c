@@ -0,0 +1,158 @@
+/*
+============================
+        sched_tune.c
+   CPU affinity and real-time scheduling options:
+   - Parses cpuset-style CPU lists
+   - Pins the calling thread (referee or render thread)
+   - Switches the calling thread to SCHED_FIFO, falling back to the
+     normal policy when that is not permitted
+   - Places each forked player before it execs
+============================
+*/
+
+#define _GNU_SOURCE
+#include "sched_tune.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+
+static cpu_set_t gDefaultCpus;          // affinity of the referee at start-up
+static int       gDefaultCpusSaved = 0;
+
+// ----------------------------
+// parseCpuList
+// "0-2,5" => {0,1,2,5}. Returns the number of CPUs, or -1 if the list
+// is malformed, empty or names a CPU beyond CPU_SETSIZE.
+// ----------------------------
+int parseCpuList(const char* list, cpu_set_t* set) {
+    CPU_ZERO(set);
+    const char* p = list;
+    while (*p) {
+        char* end;
+        long lo = strtol(p, &end, 10);
+        if (end == p || lo < 0) return -1;
+        long hi = lo;
+        p = end;
+        if (*p == '-') {
+            hi = strtol(p + 1, &end, 10);
+            if (end == p + 1 || hi < lo) return -1;
+            p = end;
+        }
+        if (hi >= CPU_SETSIZE) return -1;
+        for (long c = lo; c <= hi; c++) CPU_SET(c, set);
+        if (*p == ',') {
+            p++;
+        } else if (*p != '\0') {
+            return -1;
+        }
+    }
+    int n = CPU_COUNT(set);
+    return n > 0 ? n : -1;
+}
+
+// ----------------------------
+// saveDefaultAffinity
+// Remember the referee's start-up affinity, so players forked from a
+// pinned referee thread can be given the full set back.
+// ----------------------------
+void saveDefaultAffinity(void) {
+    if (sched_getaffinity(0, sizeof(gDefaultCpus), &gDefaultCpus) == 0) {
+        gDefaultCpusSaved = 1;
+    }
+}
+
+// ----------------------------
+// pinThreadToCpus
+// Restrict the calling thread to `list` (NULL or "" = leave as is).
+// Returns 0 on success, -1 on error (the thread keeps its affinity).
+// ----------------------------
+int pinThreadToCpus(const char* who, const char* list) {
+    if (!list || !*list) return 0;
+    cpu_set_t set;
+    if (parseCpuList(list, &set) == -1) {
+        fprintf(stderr, "[Referee] Bad CPU list '%s' for %s\n", list, who);
+        return -1;
+    }
+    // pid 0 = the calling thread on Linux
+    if (sched_setaffinity(0, sizeof(set), &set) == -1) {
+        fprintf(stderr, "[Referee] Could not pin %s to CPUs %s: %s\n", who, list, strerror(errno));
+        return -1;
+    }
+    printf("[Referee] %s pinned to CPUs %s\n", who, list);
+    return 0;
+}
+
+// ----------------------------
+// setThreadRealtime
+// Run the calling thread under SCHED_FIFO at `priority` (0 = off).
+// Returns 0 if applied or off, -1 if refused (normal policy kept).
+// ----------------------------
+int setThreadRealtime(const char* who, int priority) {
+    if (priority <= 0) return 0;
+    int lo = sched_get_priority_min(SCHED_FIFO);
+    int hi = sched_get_priority_max(SCHED_FIFO);
+    if (priority < lo) priority = lo;
+    if (priority > hi) priority = hi;
+
+    struct sched_param param = { .sched_priority = priority };
+    if (sched_setscheduler(0, SCHED_FIFO | SCHED_RESET_ON_FORK, &param) == -1) {
+        if (errno == EPERM) {
+            printf("[Referee] SCHED_FIFO not permitted for %s; keeping the normal policy\n", who);
+        } else {
+            fprintf(stderr, "[Referee] SCHED_FIFO for %s failed: %s\n", who, strerror(errno));
+        }
+        return -1;
+    }
+    printf("[Referee] %s running SCHED_FIFO priority %d\n", who, priority);
+    return 0;
+}
+
+// ----------------------------
+// preparePlayerSched
+// Called by the referee before forking player `index`. A player gets
+// the index-th CPU of cpuList (round-robin), or the referee's start-up
+// affinity when no list is given; and SCHED_FIFO when priority > 0.
+// ----------------------------
+void preparePlayerSched(PlayerSched* ps, const char* cpuList, int priority, int index) {
+    memset(ps, 0, sizeof(*ps));
+    cpu_set_t set;
+    int n = (cpuList && *cpuList) ? parseCpuList(cpuList, &set) : -1;
+    if (n > 0) {
+        int want = index % n;
+        for (int c = 0; c < CPU_SETSIZE; c++) {
+            if (!CPU_ISSET(c, &set)) continue;
+            if (want-- == 0) {
+                CPU_ZERO(&ps->cpus);
+                CPU_SET(c, &ps->cpus);
+                ps->haveCpus = 1;
+                break;
+            }
+        }
+    } else if (gDefaultCpusSaved) {
+        ps->cpus     = gDefaultCpus;
+        ps->haveCpus = 1;
+    }
+    ps->priority = priority;
+    snprintf(ps->pinError, sizeof(ps->pinError), "[Referee] Could not pin player %d\n", index);
+    snprintf(ps->fifoError, sizeof(ps->fifoError), "[Referee] SCHED_FIFO for player %d failed\n", index);
+}
+
+// ----------------------------
+// applyPlayerSched
+// Called in the forked child before execl: system calls and write(2)
+// only. Failures are reported and ignored: the player still runs,
+// just unplaced.
+// ----------------------------
+void applyPlayerSched(const PlayerSched* ps) {
+    if (ps->haveCpus && sched_setaffinity(0, sizeof(ps->cpus), &ps->cpus) == -1) {
+        write(STDERR_FILENO, ps->pinError, strlen(ps->pinError));
+    }
+    if (ps->priority > 0) {
+        struct sched_param param = { .sched_priority = ps->priority };
+        if (sched_setscheduler(0, SCHED_FIFO, &param) == -1 && errno != EPERM) {
+            write(STDERR_FILENO, ps->fifoError, strlen(ps->fifoError));
+        }
+    }
+}
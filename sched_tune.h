@@ -0,0 +1,42 @@
+#ifndef SCHED_TUNE_H
+#define SCHED_TUNE_H
+
+/*
+  sched_tune.h
+  ------------
+  Optional CPU placement and real-time scheduling for the referee
+  thread, the render (GLUT) thread and the player processes.
+
+  CPU lists use the cpuset syntax ("3", "0,2", "4-7", "0-1,6").
+  Players are pinned one CPU each, round-robin over their list.
+  SCHED_FIFO is requested with SCHED_RESET_ON_FORK, so players forked
+  by a real-time referee start as normal tasks; when the kernel refuses
+  (no CAP_SYS_NICE / RLIMIT_RTPRIO) we keep the normal policy.
+*/
+
+#include <sched.h>   // cpu_set_t needs _GNU_SOURCE in the including file
+
+// ============================
+// Player placement
+// Worked out by the referee before fork(), so the forked child (of a
+// multithreaded process) only makes system calls before execl.
+// ============================
+typedef struct {
+    cpu_set_t cpus;
+    int       haveCpus;        // 0 = keep the inherited affinity
+    int       priority;        // SCHED_FIFO priority, 0 = normal policy
+    char      pinError[64];    // reported by the child if a call fails
+    char      fifoError[64];
+} PlayerSched;
+
+// ============================
+// Function Prototypes
+// ============================
+int  parseCpuList(const char* list, cpu_set_t* set);
+void saveDefaultAffinity(void);
+int  pinThreadToCpus(const char* who, const char* list);
+int  setThreadRealtime(const char* who, int priority);
+void preparePlayerSched(PlayerSched* ps, const char* cpuList, int priority, int index);
+void applyPlayerSched(const PlayerSched* ps);
+
+#endif // SCHED_TUNE_H
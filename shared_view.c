@@ -0,0 +1,72 @@
+/*
+============================
+        shared_view.c
+   Referee side of the spectator view:
+   - Creates and maps the named shared-memory object
+   - Removes the name at exit (mapped spectators keep their view)
+============================
+*/
+
+#include "shared_view.h"
+#include <stdio.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+
+static SharedView* gView     = NULL;
+static const char* gViewName = NULL;
+
+// ----------------------------
+// openSharedView
+// Create (or reuse) the object `name` ("/rope-game") and map it.
+// Returns 0 on success, -1 on error (the game runs without a view).
+// ----------------------------
+int openSharedView(const char* name) {
+    int fd = shm_open(name, O_CREAT | O_RDWR | O_CLOEXEC, 0644);
+    if (fd == -1) {
+        perror("[Referee] shm_open view");
+        return -1;
+    }
+    if (ftruncate(fd, sizeof(SharedView)) == -1) {
+        perror("[Referee] ftruncate view");
+        close(fd);
+        return -1;
+    }
+    void* p = mmap(NULL, sizeof(SharedView), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (p == MAP_FAILED) {
+        perror("[Referee] mmap view");
+        return -1;
+    }
+    gView     = p;
+    gViewName = name;
+
+    // Invalidate first so a spectator of a previous game does not
+    // mistake the old contents for ours.
+    gView->magic = 0;
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    memset(&gView->game, 0, sizeof(gView->game));
+    memset(&gView->rope, 0, sizeof(gView->rope));
+    gView->gameSeq    = 0;
+    gView->ropeSeq    = 0;
+    gView->version    = VIEW_VERSION;
+    gView->refereePid = (int32_t)getpid();
+    __atomic_store_n(&gView->magic, VIEW_MAGIC, __ATOMIC_RELEASE);
+    printf("[Referee] Spectator view published at %s (%zu bytes)\n", name, sizeof(SharedView));
+    return 0;
+}
+
+SharedView* sharedView(void) {
+    return gView;
+}
+
+// ----------------------------
+// closeSharedView
+// atexit hook: unmap and remove the name.
+// ----------------------------
+void closeSharedView(void) {
+    if (!gView) return;
+    munmap(gView, sizeof(SharedView));
+    gView = NULL;
+    shm_unlink(gViewName);
+}
@@ -0,0 +1,111 @@
+#ifndef SHARED_VIEW_H
+#define SHARED_VIEW_H
+
+/*
+  shared_view.h
+  -------------
+  Read-only live view of a game for spectator processes.
+
+  The referee publishes into a named POSIX shared-memory object
+  (shm_open); spectators map it PROT_READ and never talk to the
+  referee. Each section is guarded by a seqlock with exactly one
+  writer: the game section is written by the referee thread once per
+  tick, the rope section by the render thread once per frame.
+
+  Writer: seq becomes odd, the payload is stored, seq becomes even.
+  Reader: copy the payload between two reads of seq and retry if seq
+  was odd or changed. Writers never wait for readers, so any number of
+  spectators costs the referee nothing.
+*/
+
+#include <stdint.h>
+#include <string.h>
+
+#define VIEW_MAGIC       0x56535052u  // "RPSV"
+#define VIEW_VERSION     1
+#define VIEW_MAX_PLAYERS 8
+#define VIEW_MAX_NODES   64
+
+// ============================
+// Payloads
+// ============================
+typedef struct {
+    int64_t  publishedNs;       // CLOCK_MONOTONIC of this snapshot
+    uint32_t tickSeq;
+    int32_t  gameOver;
+    int32_t  roundNumber;
+    int32_t  roundInProgress;
+    int32_t  roundTick;         // ticks elapsed in the current round
+    int32_t  roundTicks;        // ticks before a round ends with no winner
+    int32_t  scoreTeam1, scoreTeam2;
+    int32_t  consecutiveWinsTeam1, consecutiveWinsTeam2;
+    int32_t  winThreshold, maxRounds, consecutiveWinLimit;
+    int32_t  sumTeam1, sumTeam2;
+    int32_t  playerCount;
+    int32_t  id[VIEW_MAX_PLAYERS];
+    int32_t  energy[VIEW_MAX_PLAYERS];
+    uint8_t  team[VIEW_MAX_PLAYERS];
+    uint8_t  factor[VIEW_MAX_PLAYERS];
+    uint8_t  fallen[VIEW_MAX_PLAYERS];
+    uint8_t  pad[VIEW_MAX_PLAYERS];
+} ViewGame;
+
+typedef struct {
+    int64_t  publishedNs;
+    float    ropeShift;
+    float    ropeTargetShift;
+    int32_t  nodeCount;
+    float    x[VIEW_MAX_NODES];
+    float    y[VIEW_MAX_NODES];
+} ViewRope;
+
+// ============================
+// Shared region layout
+// ============================
+typedef struct {
+    uint32_t magic;
+    uint32_t version;
+    int32_t  refereePid;
+    uint32_t pad;
+
+    uint32_t gameSeq;          // seqlock for `game`
+    uint32_t ropeSeq;          // seqlock for `rope`
+    ViewGame game;
+    ViewRope rope;
+} SharedView;
+
+// ============================
+// Seqlock helpers
+// ============================
+static inline void viewWriteBegin(uint32_t* seq) {
+    __atomic_store_n(seq, *seq + 1, __ATOMIC_RELAXED);   // odd: write in progress
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+}
+
+static inline void viewWriteEnd(uint32_t* seq) {
+    __atomic_store_n(seq, *seq + 1, __ATOMIC_RELEASE);   // even: snapshot complete
+}
+
+// Copy a consistent snapshot of `size` bytes at `src` into `dst`.
+// Returns the number of retries it took (torn or in-progress reads).
+static inline int viewRead(const uint32_t* seq, const void* src, void* dst, size_t size) {
+    int retries = 0;
+    for (;;) {
+        uint32_t before = __atomic_load_n(seq, __ATOMIC_ACQUIRE);
+        if ((before & 1) == 0) {
+            memcpy(dst, src, size);
+            __atomic_thread_fence(__ATOMIC_ACQUIRE);
+            if (__atomic_load_n(seq, __ATOMIC_RELAXED) == before) return retries;
+        }
+        retries++;
+    }
+}
+
+// ============================
+// Function Prototypes (referee side)
+// ============================
+int  openSharedView(const char* name);
+void closeSharedView(void);
+SharedView* sharedView(void);
+
+#endif // SHARED_VIEW_H
@@ -0,0 +1,160 @@
+/*
+============================
+         spectator.c
+   Terminal dashboard for a running game:
+   - Maps the referee's shared-memory view read-only
+   - Takes consistent snapshots through the seqlocks (no syscalls,
+     no effect on the referee)
+   - Redraws scores, team sums, players and the rope position
+   Usage: spectator [/view-name] [--interval-ms=<n>] [--once]
+============================
+*/
+
+#define _POSIX_C_SOURCE 200809L
+#include "game_logic.h"
+#include "scene.h"
+#include "shared_view.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#define ROPE_WIDTH 61   // characters in the rope gauge
+
+static long long nowNs(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (long long)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+static void sleepMs(long ms) {
+    struct timespec ts = { ms / 1000, (ms % 1000) * 1000000L };
+    nanosleep(&ts, NULL);
+}
+
+// ----------------------------
+// mapView
+// Wait (up to ~10 s) for the referee to create and initialize the view.
+// ----------------------------
+static const SharedView* mapView(const char* name) {
+    for (int attempt = 0; attempt < 100; attempt++) {
+        int fd = shm_open(name, O_RDONLY, 0);
+        if (fd != -1) {
+            struct stat st;
+            if (fstat(fd, &st) == 0 && st.st_size >= (off_t)sizeof(SharedView)) {
+                const SharedView* v = mmap(NULL, sizeof(SharedView), PROT_READ, MAP_SHARED, fd, 0);
+                close(fd);
+                if (v == MAP_FAILED) {
+                    perror("mmap");
+                    return NULL;
+                }
+                if (__atomic_load_n(&v->magic, __ATOMIC_ACQUIRE) == VIEW_MAGIC &&
+                    v->version == VIEW_VERSION) {
+                    return v;
+                }
+                munmap((void*)v, sizeof(SharedView));
+            } else {
+                close(fd);
+            }
+        } else if (errno != ENOENT) {
+            perror("shm_open");
+            return NULL;
+        }
+        sleepMs(100);
+    }
+    fprintf(stderr, "No game view at %s\n", name);
+    return NULL;
+}
+
+// ----------------------------
+// drawRopeGauge
+// '|' marks the centre, 'O' the rope centre shifted toward the
+// stronger team (left = Team 1, right = Team 2).
+// ----------------------------
+static void drawRopeGauge(const ViewRope* rope, const ViewGame* game) {
+    char bar[ROPE_WIDTH + 1];
+    memset(bar, '-', ROPE_WIDTH);
+    bar[ROPE_WIDTH] = '\0';
+    int mid = ROPE_WIDTH / 2;
+    bar[mid] = '|';
+
+    // Without a window there is no rope simulation; use the tick's sums.
+    double shift = rope->nodeCount ? rope->ropeShift
+                                   : ROPE_SHIFT_PER_SUM * (game->sumTeam2 - game->sumTeam1);
+    int threshold = game->winThreshold > 0 ? game->winThreshold : DEFAULT_WIN_THRESHOLD;
+    double scale = ROPE_SHIFT_PER_SUM * threshold;
+    int pos = mid + (int)(shift / scale * mid);
+    if (pos < 0) pos = 0;
+    if (pos >= ROPE_WIDTH) pos = ROPE_WIDTH - 1;
+    bar[pos] = 'O';
+    printf("  T1 %s T2   shift=%+.1f\n", bar, shift);
+}
+
+static void drawFrame(const ViewGame* g, const ViewRope* r, long long retries, int clear) {
+    if (clear) printf("\033[H\033[J");
+    long long age = nowNs() - g->publishedNs;
+    printf("Rope Pulling Game - spectator   tick #%u   snapshot age %.1f ms   seqlock retries %lld\n\n",
+           g->tickSeq, age / 1e6, retries);
+    printf("  Round %d/%d %s   tick %d/%d   threshold %d   streak limit %d\n",
+           g->roundNumber, g->maxRounds, g->roundInProgress ? "(in progress)" : "(between rounds)",
+           g->roundTick, g->roundTicks, g->winThreshold, g->consecutiveWinLimit);
+    printf("  Score  Team 1: %d (streak %d)   Team 2: %d (streak %d)\n",
+           g->scoreTeam1, g->consecutiveWinsTeam1, g->scoreTeam2, g->consecutiveWinsTeam2);
+    printf("  Sums   Team 1: %d   Team 2: %d\n\n", g->sumTeam1, g->sumTeam2);
+    drawRopeGauge(r, g);
+    printf("\n  %-6s %-5s %-7s %-8s %s\n", "Player", "Team", "Factor", "Energy", "State");
+    for (int i = 0; i < g->playerCount && i < VIEW_MAX_PLAYERS; i++) {
+        printf("  %-6d %-5d %-7d %-8d %s\n", g->id[i], g->team[i], g->factor[i], g->energy[i],
+               g->fallen[i] ? "fallen" : "pulling");
+    }
+    if (g->gameOver) {
+        printf("\n  Game over: %s\n", g->scoreTeam1 > g->scoreTeam2 ? "Team 1 wins" :
+                                      g->scoreTeam2 > g->scoreTeam1 ? "Team 2 wins" : "draw");
+    }
+    fflush(stdout);
+}
+
+int main(int argc, char* argv[]) {
+    const char* name = "/rope-game";
+    long intervalMs = 100;
+    int once = 0;
+    for (int i = 1; i < argc; i++) {
+        if (strncmp(argv[i], "--interval-ms=", 14) == 0) {
+            intervalMs = atol(argv[i] + 14);
+        } else if (strcmp(argv[i], "--once") == 0) {
+            once = 1;
+        } else if (argv[i][0] != '-') {
+            name = argv[i];
+        } else {
+            fprintf(stderr, "Usage: %s [/view-name] [--interval-ms=<n>] [--once]\n", argv[0]);
+            exit(EXIT_FAILURE);
+        }
+    }
+    if (intervalMs < 1) intervalMs = 1;
+
+    const SharedView* view = mapView(name);
+    if (!view) exit(EXIT_FAILURE);
+
+    long long retries = 0;
+    ViewGame game;
+    ViewRope rope;
+    for (;;) {
+        retries += viewRead(&view->gameSeq, &view->game, &game, sizeof(game));
+        retries += viewRead(&view->ropeSeq, &view->rope, &rope, sizeof(rope));
+        drawFrame(&game, &rope, retries, !once);
+        if (once || game.gameOver) break;
+        if (kill(view->refereePid, 0) == -1 && errno == ESRCH) {
+            printf("\n  Referee (pid %d) has exited.\n", view->refereePid);
+            break;
+        }
+        sleepMs(intervalMs);
+    }
+    munmap((void*)view, sizeof(SharedView));
+    return 0;
+}
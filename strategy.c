@@ -0,0 +1,115 @@
+/*
+============================
+         strategy.c
+   Player strategy files:
+   - strategyDefault: effort 1 on every tick (the original player)
+   - loadStrategy: read "key = value" weights ('#' comments)
+   - saveStrategy: write them back, "<path>.tmp" then rename
+============================
+*/
+
+#include "strategy.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+
+static const char* gWeightNames[STRATEGY_WEIGHTS] = { "bias", "energy", "factor", "round", "lead" };
+
+static double* weightAt(Strategy* s, int k) {
+    double* w[STRATEGY_WEIGHTS] = { &s->bias, &s->energy, &s->factor, &s->round, &s->lead };
+    return w[k];
+}
+
+void strategyDefault(Strategy* s) {
+    memset(s, 0, sizeof(*s));
+    s->bias = 1.0;
+}
+
+static char* trim(char* s) {
+    while (isspace((unsigned char)*s)) s++;
+    char* end = s + strlen(s);
+    while (end > s && isspace((unsigned char)end[-1])) end--;
+    *end = '\0';
+    return s;
+}
+
+// ----------------------------
+// loadStrategy
+// Weights missing from the file keep their default (bias 1, others 0).
+// Returns 0 on success, -1 if the file cannot be read or has a bad line.
+// ----------------------------
+int loadStrategy(const char* path, Strategy* s) {
+    strategyDefault(s);
+    FILE* fp = fopen(path, "r");
+    if (!fp) {
+        perror(path);
+        return -1;
+    }
+    char line[256];
+    int lineNo = 0, errors = 0;
+    while (fgets(line, sizeof(line), fp)) {
+        lineNo++;
+        char* hash = strchr(line, '#');
+        if (hash) *hash = '\0';
+        char* eq = strchr(line, '=');
+        if (!eq) {
+            if (*trim(line) != '\0') errors++;
+            continue;
+        }
+        *eq = '\0';
+        char* key   = trim(line);
+        char* value = trim(eq + 1);
+        char* end   = NULL;
+        double v = strtod(value, &end);
+        int k = 0;
+        while (k < STRATEGY_WEIGHTS && strcmp(key, gWeightNames[k]) != 0) k++;
+        if (k == STRATEGY_WEIGHTS || end == value || *end != '\0') {
+            fprintf(stderr, "%s:%d: bad strategy line\n", path, lineNo);
+            errors++;
+            continue;
+        }
+        *weightAt(s, k) = v;
+    }
+    fclose(fp);
+    return errors ? -1 : 0;
+}
+
+// ----------------------------
+// saveStrategy
+// `comment` (may be NULL or several lines) goes at the top as '#' lines.
+// Returns 0 on success, -1 on error.
+// ----------------------------
+int saveStrategy(const char* path, const Strategy* s, const char* comment) {
+    char tmp[512];
+    snprintf(tmp, sizeof(tmp), "%s.tmp", path);
+    FILE* fp = fopen(tmp, "w");
+    if (!fp) {
+        perror(tmp);
+        return -1;
+    }
+    while (comment && *comment) {
+        const char* nl = strchr(comment, '\n');
+        int len = nl ? (int)(nl - comment) : (int)strlen(comment);
+        fprintf(fp, "# %.*s\n", len, comment);
+        comment += len + (nl != NULL);
+    }
+    for (int k = 0; k < STRATEGY_WEIGHTS; k++) {
+        fprintf(fp, "%-6s = %.6f\n", gWeightNames[k], *weightAt((Strategy*)s, k));
+    }
+    if (fclose(fp) != 0 || rename(tmp, path) == -1) {
+        perror(path);
+        return -1;
+    }
+    return 0;
+}
+
+// One-line summary for logs: "bias=1.000 energy=0.000 ..."
+void formatStrategy(const Strategy* s, char* out, unsigned size) {
+    int len = 0;
+    out[0] = '\0';
+    for (int k = 0; k < STRATEGY_WEIGHTS && len < (int)size; k++) {
+        len += snprintf(out + len, size - len, "%s%s=%.3f", k ? " " : "", gWeightNames[k],
+                        *weightAt((Strategy*)s, k));
+    }
+}
@@ -0,0 +1,89 @@
+#ifndef STRATEGY_H
+#define STRATEGY_H
+
+/*
+  strategy.h
+  ----------
+  Player strategies: how hard a player pulls on each tick.
+
+  A strategy maps what a player knows when it reports (its energy, its
+  position factor, the round and the score) to an effort in
+  [0, STRATEGY_EFFORT_MAX]. The report is energy * factor * effort, and
+  the tick costs STRATEGY_FATIGUE * (effort^2 - 1) energy: pulling
+  harder than 1 drains the player, easing off recovers (never above its
+  roster energy). Effort 1 costs nothing and reports what the player
+  always has, so the default strategy is the original behaviour.
+
+  The policy is linear in normalized features:
+    effort = bias + energy * (energy / roster energy)
+                  + factor * (factor - 1) / 3
+                  + round  * (round - 1) / (max rounds - 1)
+                  + lead   * (own score - other score) / max rounds
+  Strategies are small "key = value" text files (see saveStrategy),
+  written by ./evolve and loaded by players with --strategy=<file>.
+*/
+
+#define STRATEGY_EFFORT_MAX 2.0
+#define STRATEGY_FATIGUE    10.0   // energy per tick at effort 0 (gained) or sqrt(2) (lost)
+
+// ============================
+// Strategy (policy weights)
+// ============================
+typedef struct {
+    double bias;
+    double energy;
+    double factor;
+    double round;
+    double lead;
+} Strategy;
+
+#define STRATEGY_WEIGHTS 5   // doubles in a Strategy, in the order above
+
+// What a player knows when it reports
+typedef struct {
+    double energy;          // current energy (before the factor)
+    double rosterEnergy;    // energy it started the game with
+    int    factor;          // 1..4
+    int    round;           // 1-based
+    int    maxRounds;
+    int    ownScore;
+    int    otherScore;
+} StrategyContext;
+
+// ============================
+// Function Prototypes
+// ============================
+void strategyDefault(Strategy* s);
+int  loadStrategy(const char* path, Strategy* s);
+int  saveStrategy(const char* path, const Strategy* s, const char* comment);
+void formatStrategy(const Strategy* s, char* out, unsigned size);
+
+// ----------------------------
+// strategyEffort
+// Pure arithmetic: safe in the player's signal handlers and cheap in
+// the evaluator's inner loop.
+// ----------------------------
+static inline double strategyEffort(const Strategy* s, const StrategyContext* c) {
+    double energy = c->rosterEnergy > 0 ? c->energy / c->rosterEnergy : 0.0;
+    double round  = c->maxRounds > 1 ? (double)(c->round - 1) / (c->maxRounds - 1) : 0.0;
+    double lead   = c->maxRounds > 0 ? (double)(c->ownScore - c->otherScore) / c->maxRounds : 0.0;
+    double e = s->bias + s->energy * energy + s->factor * (c->factor - 1) / 3.0 +
+               s->round * round + s->lead * lead;
+    if (e < 0.0) e = 0.0;
+    if (e > STRATEGY_EFFORT_MAX) e = STRATEGY_EFFORT_MAX;
+    return e;
+}
+
+// ----------------------------
+// strategyFatigue
+// Energy after a tick pulled at `effort`, kept within [0, rosterEnergy].
+// ----------------------------
+static inline double strategyFatigue(double energy, double rosterEnergy, double effort) {
+    if (effort == 1.0) return energy;   // exact: the default strategy never touches energy
+    energy -= STRATEGY_FATIGUE * (effort * effort - 1.0);
+    if (energy < 0.0) energy = 0.0;
+    if (energy > rosterEnergy) energy = rosterEnergy;
+    return energy;
+}
+
+#endif // STRATEGY_H
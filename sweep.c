@@ -0,0 +1,469 @@
+/*
+============================
+           sweep.c
+   Parallel parameter sweep for game balancing:
+   - Expands ranges for threshold, max rounds, consecutive-win limit,
+     depletion range and per-team roster energy scale into a grid
+   - Runs every (point, seed) as a headless, time-compressed referee,
+     up to --jobs at a time
+   - Memoizes each result in a content-addressed cache keyed by a hash of
+     (parameters, roster, strategy files, seed, ENGINE_VERSION), so
+     re-running a sweep
+     only computes new points
+   - Prints the most balanced configurations
+============================
+*/
+
+#define _GNU_SOURCE
+#include "game_logic.h"
+#include "results_store.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+
+#define MAX_ROSTER 8
+
+// ============================
+// Sweep parameters
+// ============================
+typedef struct {
+    double lo, hi, step;
+} Range;
+
+typedef struct {
+    int    threshold;
+    int    maxRounds;
+    int    consecutive;
+    int    depletionMin;
+    int    depletionMax;
+    double scale1;          // multiplies Team 1 roster energies
+    double scale2;          // multiplies Team 2 roster energies
+    char   roster[256];     // generated roster file
+    // aggregated over seeds
+    int    games, wins1, wins2;
+    long   rounds;
+    double balance;         // |P(T1 wins) - P(T2 wins)|, lower is better
+} SweepPoint;
+
+typedef struct {
+    int      point;
+    unsigned seed;
+    uint64_t key;
+    pid_t    pid;
+    int      score1, score2, rounds, ticks;
+    int      ok;
+} SweepJob;
+
+typedef struct {
+    int    id, team;
+    double energy;
+    char   strategy[200];   // roster strategy column ("" = default strategy)
+} RosterEntry;
+
+static Range       gThreshold   = { 500, 500, 1 };
+static Range       gMaxRounds   = { 5, 5, 1 };
+static Range       gConsecutive = { 2, 2, 1 };
+static Range       gDepMin      = { 5, 5, 1 };
+static Range       gDepMax      = { 14, 14, 1 };
+static Range       gScale1      = { 1, 1, 1 };
+static Range       gScale2      = { 1, 1, 1 };
+static int         gSeeds       = 8;
+static int         gJobs        = 0;
+static int         gTop         = 10;
+static int         gRoundTicks  = 10;
+static double      gCompression = 1000;
+static const char* gCacheDir    = ".sweep_cache";
+static const char* gParentPath  = "./parent";
+
+static RosterEntry gBase[MAX_ROSTER];
+static int         gBaseCount = 0;
+static uint64_t    gStrategyHash = FNV1A64_INIT;   // contents of the roster's strategy files
+
+// ----------------------------
+// parseRange
+// "lo:hi:step", "lo:hi" (step 1) or a single value.
+// ----------------------------
+static int parseRange(const char* s, Range* r) {
+    int n = sscanf(s, "%lf:%lf:%lf", &r->lo, &r->hi, &r->step);
+    if (n == 1) { r->hi = r->lo; r->step = 1; }
+    if (n == 2) r->step = 1;
+    return (n >= 1 && r->step > 0 && r->hi >= r->lo) ? 0 : -1;
+}
+
+static int rangeCount(const Range* r) {
+    return (int)floor((r->hi - r->lo) / r->step + 1e-9) + 1;
+}
+
+static double rangeAt(const Range* r, int i) {
+    return r->lo + i * r->step;
+}
+
+// ----------------------------
+// hashStrategyFile
+// Fold a strategy file's contents into hash, so editing a strategy
+// invalidates the cached results that used it.
+// ----------------------------
+static uint64_t hashStrategyFile(const char* filename, uint64_t hash) {
+    FILE* fp = fopen(filename, "r");
+    if (!fp) {
+        fprintf(stderr, "Cannot read strategy %s: %s\n", filename, strerror(errno));
+        exit(EXIT_FAILURE);
+    }
+    char buf[4096];
+    size_t n;
+    while ((n = fread(buf, 1, sizeof(buf), fp)) > 0) hash = fnv1a64(buf, n, hash);
+    fclose(fp);
+    return hash;
+}
+
+// ----------------------------
+// readRoster
+// Same format as PlayersConfiguration.txt: "<id> <team> <energy> [strategy]".
+// ----------------------------
+static void readRoster(const char* filename) {
+    FILE* fp = fopen(filename, "r");
+    if (!fp) {
+        perror("Could not open roster file");
+        exit(EXIT_FAILURE);
+    }
+    char line[256];
+    while (fgets(line, sizeof(line), fp) && gBaseCount < MAX_ROSTER) {
+        if (line[0] == '#' || line[0] == '\n') continue;
+        RosterEntry* e = &gBase[gBaseCount];
+        e->strategy[0] = '\0';
+        int fields = sscanf(line, "%d %d %lf %199s", &e->id, &e->team, &e->energy, e->strategy);
+        if (fields < 3) continue;
+        if (fields == 4) {
+            gStrategyHash = fnv1a64(e->strategy, strlen(e->strategy), gStrategyHash);
+            gStrategyHash = hashStrategyFile(e->strategy, gStrategyHash);
+        }
+        gBaseCount++;
+    }
+    fclose(fp);
+    if (gBaseCount != MAX_ROSTER) {
+        fprintf(stderr, "Roster %s has %d players, expected %d\n", filename, gBaseCount, MAX_ROSTER);
+        exit(EXIT_FAILURE);
+    }
+}
+
+// ----------------------------
+// writeScaledRoster
+// Roster files are content-addressed too: identical scaled rosters share
+// one file, and the roster text feeds the cache key. Strategy paths are
+// copied as written; the referee runs in our working directory.
+// Returns the hash of the roster text.
+// ----------------------------
+static uint64_t writeScaledRoster(SweepPoint* p) {
+    char text[MAX_ROSTER * 256];
+    int len = 0;
+    for (int i = 0; i < gBaseCount; i++) {
+        double scale = gBase[i].team == 1 ? p->scale1 : p->scale2;
+        const char* strategy = gBase[i].strategy;
+        len += snprintf(text + len, sizeof(text) - len, "%d %d %.1f%s%s\n",
+                        gBase[i].id, gBase[i].team, gBase[i].energy * scale,
+                        *strategy ? " " : "", strategy);
+    }
+    uint64_t h = fnv1a64(text, len, FNV1A64_INIT);
+    snprintf(p->roster, sizeof(p->roster), "%s/roster-%016llx.txt", gCacheDir, (unsigned long long)h);
+
+    if (access(p->roster, R_OK) != 0) {
+        FILE* fp = fopen(p->roster, "w");
+        if (!fp) {
+            perror("write roster");
+            exit(EXIT_FAILURE);
+        }
+        fwrite(text, 1, len, fp);
+        fclose(fp);
+    }
+    return h;
+}
+
+// ----------------------------
+// jobKey
+// Content address of one (point, seed) result.
+// ----------------------------
+static uint64_t jobKey(const SweepPoint* p, uint64_t rosterHash, unsigned seed) {
+    char key[256];
+    int len = snprintf(key, sizeof(key),
+                       "engine=%d threshold=%d rounds=%d consecutive=%d depletion=%d:%d "
+                       "roster=%016llx strategies=%016llx seed=%u round_ticks=%d",
+                       ENGINE_VERSION, p->threshold, p->maxRounds, p->consecutive,
+                       p->depletionMin, p->depletionMax,
+                       (unsigned long long)rosterHash, (unsigned long long)gStrategyHash,
+                       seed, gRoundTicks);
+    return fnv1a64(key, len, FNV1A64_INIT);
+}
+
+static void cachePath(char* out, size_t size, uint64_t key, const char* suffix) {
+    snprintf(out, size, "%s/%016llx%s", gCacheDir, (unsigned long long)key, suffix);
+}
+
+// ----------------------------
+// cacheLoad / cacheStore
+// One small text file per result: "<score1> <score2> <rounds> <ticks>".
+// Stores go through a temp file + rename so readers never see a partial entry.
+// ----------------------------
+static int cacheLoad(SweepJob* job) {
+    char path[512];
+    cachePath(path, sizeof(path), job->key, "");
+    FILE* fp = fopen(path, "r");
+    if (!fp) return -1;
+    int n = fscanf(fp, "%d %d %d %d", &job->score1, &job->score2, &job->rounds, &job->ticks);
+    fclose(fp);
+    job->ok = (n == 4);
+    return job->ok ? 0 : -1;
+}
+
+static void cacheStore(const SweepJob* job) {
+    char path[512], tmp[512];
+    cachePath(path, sizeof(path), job->key, "");
+    cachePath(tmp, sizeof(tmp), job->key, ".tmp");
+    FILE* fp = fopen(tmp, "w");
+    if (!fp) {
+        perror("cache write");
+        return;
+    }
+    fprintf(fp, "%d %d %d %d\n", job->score1, job->score2, job->rounds, job->ticks);
+    fclose(fp);
+    rename(tmp, path);
+}
+
+// ----------------------------
+// startJob
+// Fork a headless referee for one (point, seed). Every setting that
+// affects the outcome is passed explicitly so config.txt cannot leak in.
+// ----------------------------
+static void startJob(SweepJob* job, const SweepPoint* p) {
+    char results[512];
+    cachePath(results, sizeof(results), job->key, ".col");
+    unlink(results);
+
+    job->pid = fork();
+    if (job->pid < 0) {
+        perror("fork");
+        exit(EXIT_FAILURE);
+    }
+    if (job->pid > 0) return;
+
+    int devnull = open("/dev/null", O_WRONLY);
+    dup2(devnull, STDOUT_FILENO);
+    dup2(devnull, STDERR_FILENO);
+
+    char args[11][64];
+    snprintf(args[0],  64, "--win-threshold=%d", p->threshold);
+    snprintf(args[1],  64, "--max-rounds=%d", p->maxRounds);
+    snprintf(args[2],  64, "--consecutive-wins=%d", p->consecutive);
+    snprintf(args[3],  64, "--depletion-min=%d", p->depletionMin);
+    snprintf(args[4],  64, "--depletion-max=%d", p->depletionMax);
+    snprintf(args[5],  64, "--seed=%u", job->seed);
+    snprintf(args[6],  64, "--time-compression=%g", gCompression);
+    snprintf(args[7],  64, "--round-timeout-ms=%d", gRoundTicks * 1000);
+    snprintf(args[8],  64, "--tick-ms=1000");
+    snprintf(args[9],  64, "--settle-ms=10");
+    snprintf(args[10], 64, "--warmup-ms=1500");
+    char resultsArg[600];
+    snprintf(resultsArg, sizeof(resultsArg), "--results=%s", results);
+    execl(gParentPath, "parent", p->roster, "--headless",
+          args[0], args[1], args[2], args[3], args[4], args[5], args[6],
+          args[7], args[8], args[9], args[10], resultsArg,
+          (char*)NULL);
+    _exit(127);
+}
+
+// ----------------------------
+// finishJob
+// Read the game row the referee wrote and memoize it.
+// ----------------------------
+static void finishJob(SweepJob* job, int status) {
+    char results[512];
+    cachePath(results, sizeof(results), job->key, ".col");
+    int32_t row[GAME_COLS];
+    if (WIFEXITED(status) && WEXITSTATUS(status) == 0 && resultsLastGame(results, row) == 0) {
+        job->score1 = row[GAME_SCORE1];
+        job->score2 = row[GAME_SCORE2];
+        job->rounds = row[GAME_ROUNDS];
+        job->ticks  = row[GAME_TICKS];
+        job->ok     = 1;
+        cacheStore(job);
+    } else {
+        fprintf(stderr, "Job %016llx failed (status %d)\n", (unsigned long long)job->key, status);
+    }
+    unlink(results);
+}
+
+static int comparePoints(const void* a, const void* b) {
+    const SweepPoint* x = a;
+    const SweepPoint* y = b;
+    if (x->games == 0 || y->games == 0) return (y->games != 0) - (x->games != 0);
+    if (x->balance != y->balance) return x->balance < y->balance ? -1 : 1;
+    // Among equally balanced points prefer longer, more contested games.
+    double rx = (double)x->rounds / x->games, ry = (double)y->rounds / y->games;
+    return (rx > ry) ? -1 : (rx < ry);
+}
+
+static void usage(const char* prog) {
+    fprintf(stderr,
+            "Usage: %s [options] <roster file>\n"
+            "  Ranges are lo:hi:step (or a single value)\n"
+            "  --threshold=R  --max-rounds=R  --consecutive=R\n"
+            "  --depletion-min=R  --depletion-max=R\n"
+            "  --scale1=R  --scale2=R        (multiply Team 1 / Team 2 roster energies)\n"
+            "  --seeds=N (8)  --jobs=N (cores)  --top=N (10)  --round-ticks=N (10)\n"
+            "  --compression=X (1000)  --cache=DIR (.sweep_cache)  --parent=PATH (./parent)\n",
+            prog);
+    exit(EXIT_FAILURE);
+}
+
+int main(int argc, char* argv[]) {
+    const char* rosterFile = NULL;
+    for (int i = 1; i < argc; i++) {
+        const char* a = argv[i];
+        const char* v = strchr(a, '=');
+        v = v ? v + 1 : "";
+        int bad = 0;
+        if      (strncmp(a, "--threshold=", 12) == 0)     bad = parseRange(v, &gThreshold);
+        else if (strncmp(a, "--max-rounds=", 13) == 0)    bad = parseRange(v, &gMaxRounds);
+        else if (strncmp(a, "--consecutive=", 14) == 0)   bad = parseRange(v, &gConsecutive);
+        else if (strncmp(a, "--depletion-min=", 16) == 0) bad = parseRange(v, &gDepMin);
+        else if (strncmp(a, "--depletion-max=", 16) == 0) bad = parseRange(v, &gDepMax);
+        else if (strncmp(a, "--scale1=", 9) == 0)         bad = parseRange(v, &gScale1);
+        else if (strncmp(a, "--scale2=", 9) == 0)         bad = parseRange(v, &gScale2);
+        else if (strncmp(a, "--seeds=", 8) == 0)          gSeeds = atoi(v);
+        else if (strncmp(a, "--jobs=", 7) == 0)           gJobs = atoi(v);
+        else if (strncmp(a, "--top=", 6) == 0)            gTop = atoi(v);
+        else if (strncmp(a, "--round-ticks=", 14) == 0)   gRoundTicks = atoi(v);
+        else if (strncmp(a, "--compression=", 14) == 0)   gCompression = atof(v);
+        else if (strncmp(a, "--cache=", 8) == 0)          gCacheDir = v;
+        else if (strncmp(a, "--parent=", 9) == 0)         gParentPath = v;
+        else if (a[0] != '-')                             rosterFile = a;
+        else                                              usage(argv[0]);
+        if (bad) usage(argv[0]);
+    }
+    if (!rosterFile || gSeeds <= 0 || gRoundTicks <= 0 || gCompression <= 0) usage(argv[0]);
+    if (gJobs <= 0) gJobs = (int)sysconf(_SC_NPROCESSORS_ONLN);
+    if (gJobs <= 0) gJobs = 1;
+
+    readRoster(rosterFile);
+    if (mkdir(gCacheDir, 0755) == -1 && errno != EEXIST) {
+        perror("mkdir cache");
+        exit(EXIT_FAILURE);
+    }
+
+    // (1) Expand the grid
+    int counts[7] = {
+        rangeCount(&gThreshold), rangeCount(&gMaxRounds), rangeCount(&gConsecutive),
+        rangeCount(&gDepMin), rangeCount(&gDepMax), rangeCount(&gScale1), rangeCount(&gScale2)
+    };
+    long total = 1;
+    for (int d = 0; d < 7; d++) total *= counts[d];
+    SweepPoint* points = calloc(total, sizeof(SweepPoint));
+    SweepJob*   jobs   = calloc(total * gSeeds, sizeof(SweepJob));
+    if (!points || !jobs) {
+        perror("calloc");
+        exit(EXIT_FAILURE);
+    }
+
+    int numPoints = 0, numJobs = 0;
+    for (long g = 0; g < total; g++) {
+        int idx[7];
+        long rest = g;
+        for (int d = 6; d >= 0; d--) {
+            idx[d] = (int)(rest % counts[d]);
+            rest /= counts[d];
+        }
+        SweepPoint* p = &points[numPoints];
+        p->threshold    = (int)lround(rangeAt(&gThreshold, idx[0]));
+        p->maxRounds    = (int)lround(rangeAt(&gMaxRounds, idx[1]));
+        p->consecutive  = (int)lround(rangeAt(&gConsecutive, idx[2]));
+        p->depletionMin = (int)lround(rangeAt(&gDepMin, idx[3]));
+        p->depletionMax = (int)lround(rangeAt(&gDepMax, idx[4]));
+        p->scale1       = rangeAt(&gScale1, idx[5]);
+        p->scale2       = rangeAt(&gScale2, idx[6]);
+        if (p->depletionMin > p->depletionMax) continue;
+
+        uint64_t rosterHash = writeScaledRoster(p);
+        for (int s = 1; s <= gSeeds; s++) {
+            SweepJob* job = &jobs[numJobs++];
+            job->point = numPoints;
+            job->seed  = (unsigned)s;
+            job->key   = jobKey(p, rosterHash, job->seed);
+        }
+        numPoints++;
+    }
+
+    // (2) Serve what we can from the cache, run the rest in parallel
+    int cached = 0, computed = 0, failed = 0, running = 0, next = 0;
+    for (int j = 0; j < numJobs; j++) {
+        if (cacheLoad(&jobs[j]) == 0) cached++;
+    }
+    printf("[Sweep] %d points x %d seeds = %d games (%d cached), %d parallel jobs\n",
+           numPoints, gSeeds, numJobs, cached, gJobs);
+
+    for (;;) {
+        while (running < gJobs && next < numJobs) {
+            SweepJob* job = &jobs[next++];
+            if (job->ok) continue;
+            startJob(job, &points[job->point]);
+            running++;
+        }
+        if (running == 0) break;
+
+        int status;
+        pid_t pid = wait(&status);
+        if (pid == -1) {
+            if (errno == EINTR) continue;
+            perror("wait");
+            break;
+        }
+        for (int j = 0; j < numJobs; j++) {
+            if (jobs[j].pid == pid) {
+                jobs[j].pid = 0;
+                finishJob(&jobs[j], status);
+                if (jobs[j].ok) computed++; else failed++;
+                running--;
+                break;
+            }
+        }
+    }
+    printf("[Sweep] computed=%d cached=%d failed=%d\n", computed, cached, failed);
+
+    // (3) Aggregate and rank
+    for (int j = 0; j < numJobs; j++) {
+        if (!jobs[j].ok) continue;
+        SweepPoint* p = &points[jobs[j].point];
+        p->games++;
+        p->wins1  += jobs[j].score1 > jobs[j].score2;
+        p->wins2  += jobs[j].score2 > jobs[j].score1;
+        p->rounds += jobs[j].rounds;
+    }
+    for (int i = 0; i < numPoints; i++) {
+        SweepPoint* p = &points[i];
+        p->balance = p->games ? fabs((double)(p->wins1 - p->wins2)) / p->games : 1.0;
+    }
+    qsort(points, numPoints, sizeof(SweepPoint), comparePoints);
+
+    printf("\n%9s %6s %5s %9s %6s %6s %6s %7s %7s %6s %8s\n",
+           "threshold", "rounds", "consec", "depletion", "scale1", "scale2",
+           "games", "T1 win", "T2 win", "rnd/g", "balance");
+    for (int i = 0; i < numPoints && i < gTop; i++) {
+        const SweepPoint* p = &points[i];
+        if (p->games == 0) break;
+        char dep[16];
+        snprintf(dep, sizeof(dep), "%d:%d", p->depletionMin, p->depletionMax);
+        printf("%9d %6d %5d %9s %6.2f %6.2f %6d %6.1f%% %6.1f%% %6.2f %8.3f\n",
+               p->threshold, p->maxRounds, p->consecutive, dep, p->scale1, p->scale2,
+               p->games, 100.0 * p->wins1 / p->games, 100.0 * p->wins2 / p->games,
+               (double)p->rounds / p->games, p->balance);
+    }
+
+    free(points);
+    free(jobs);
+    return failed ? EXIT_FAILURE : 0;
+}
@@ -0,0 +1,177 @@
+/*
+============================
+        tick_clock.c
+   timerfd-backed referee tick:
+   - Arms an absolute, periodic CLOCK_MONOTONIC timer
+   - Blocks until the next tick and reports missed expirations
+   - Tracks how late each wake-up was relative to its deadline
+   - Reports tick-interval jitter percentiles
+============================
+*/
+
+#define _GNU_SOURCE
+#include "tick_clock.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <errno.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/timerfd.h>
+
+#define NS_PER_SEC 1000000000LL
+
+static struct timespec toTimespec(long long ns) {
+    struct timespec ts;
+    ts.tv_sec  = ns / NS_PER_SEC;
+    ts.tv_nsec = ns % NS_PER_SEC;
+    return ts;
+}
+
+// ----------------------------
+// monotonicNs
+// Current CLOCK_MONOTONIC time in nanoseconds.
+// ----------------------------
+long long monotonicNs(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (long long)ts.tv_sec * NS_PER_SEC + ts.tv_nsec;
+}
+
+// ----------------------------
+// tickClockOpen
+// First tick fires firstDelayNs from now, then every periodNs.
+// Returns the timerfd, or -1 on error.
+// ----------------------------
+int tickClockOpen(TickClock* clock, long long periodNs, long long firstDelayNs) {
+    clock->fd = timerfd_create(CLOCK_MONOTONIC, TFD_CLOEXEC);
+    if (clock->fd == -1) {
+        perror("timerfd_create");
+        return -1;
+    }
+    clock->periodNs   = periodNs;
+    clock->firstNs    = monotonicNs() + (firstDelayNs > 0 ? firstDelayNs : 1);
+    clock->ticks      = 0;
+    clock->missed     = 0;
+    clock->lastLateNs = 0;
+    clock->maxLateNs  = 0;
+    clock->lateNs     = NULL;
+    clock->samples    = 0;
+    clock->capacity   = 0;
+
+    struct itimerspec spec;
+    spec.it_value    = toTimespec(clock->firstNs);
+    spec.it_interval = toTimespec(periodNs);
+    if (timerfd_settime(clock->fd, TFD_TIMER_ABSTIME, &spec, NULL) == -1) {
+        perror("timerfd_settime");
+        close(clock->fd);
+        clock->fd = -1;
+        return -1;
+    }
+    return clock->fd;
+}
+
+// ----------------------------
+// recordLateness
+// Keep the latest lateness for the jitter report (stops growing at
+// TICK_SAMPLES_MAX; the worst case is still tracked in maxLateNs).
+// ----------------------------
+static void recordLateness(TickClock* clock) {
+    if (clock->samples == clock->capacity) {
+        if (clock->capacity >= TICK_SAMPLES_MAX) return;
+        size_t capacity = clock->capacity ? clock->capacity * 2 : 1024;
+        long long* grown = realloc(clock->lateNs, capacity * sizeof(long long));
+        if (!grown) return;
+        clock->lateNs   = grown;
+        clock->capacity = capacity;
+    }
+    clock->lateNs[clock->samples++] = clock->lastLateNs;
+}
+
+// ----------------------------
+// tickClockWait
+// Blocks until the next tick. Expirations beyond the first are
+// added to clock->missed. Returns the expiration count, or -1
+// if the timer was closed or failed.
+// ----------------------------
+long long tickClockWait(TickClock* clock) {
+    uint64_t expirations = 0;
+    ssize_t n;
+    do {
+        n = read(clock->fd, &expirations, sizeof(expirations));
+    } while (n == -1 && errno == EINTR);
+    if (n != sizeof(expirations)) return -1;
+
+    long long now = monotonicNs();
+    clock->ticks  += 1;
+    clock->missed += expirations - 1;
+
+    // Deadline of the most recent expiration on the absolute grid.
+    long long elapsed  = now - clock->firstNs;
+    long long deadline = clock->firstNs + (elapsed / clock->periodNs) * clock->periodNs;
+    clock->lastLateNs = now - deadline;
+    if (clock->lastLateNs > clock->maxLateNs) clock->maxLateNs = clock->lastLateNs;
+    recordLateness(clock);
+
+    return (long long)expirations;
+}
+
+// ----------------------------
+// tickClockClose
+// ----------------------------
+void tickClockClose(TickClock* clock) {
+    if (clock->fd != -1) {
+        close(clock->fd);
+        clock->fd = -1;
+    }
+    free(clock->lateNs);
+    clock->lateNs   = NULL;
+    clock->samples  = 0;
+    clock->capacity = 0;
+}
+
+static int cmpLongLong(const void* a, const void* b) {
+    long long x = *(const long long*)a, y = *(const long long*)b;
+    return (x > y) - (x < y);
+}
+
+// Nearest-rank percentile of a sorted array
+static long long percentile(const long long* sorted, size_t n, double p) {
+    size_t rank = (size_t)(p / 100.0 * n + 0.999999);
+    if (rank < 1) rank = 1;
+    if (rank > n) rank = n;
+    return sorted[rank - 1];
+}
+
+// ----------------------------
+// printTickJitter
+// Percentiles of |interval - period| (from consecutive latenesses)
+// and of wake-up lateness itself.
+// ----------------------------
+void printTickJitter(const TickClock* clock) {
+    size_t n = clock->samples;
+    if (n < 2) return;
+    long long* dev  = malloc((n - 1) * sizeof(long long));
+    long long* late = malloc(n * sizeof(long long));
+    if (!dev || !late) {
+        free(dev);
+        free(late);
+        return;
+    }
+    for (size_t k = 1; k < n; k++) {
+        long long d = clock->lateNs[k] - clock->lateNs[k - 1];
+        dev[k - 1] = d < 0 ? -d : d;
+    }
+    for (size_t k = 0; k < n; k++) late[k] = clock->lateNs[k];
+    qsort(dev, n - 1, sizeof(long long), cmpLongLong);
+    qsort(late, n, sizeof(long long), cmpLongLong);
+
+    printf("[Referee] Tick jitter over %zu intervals: |interval - period| p50=%.3f p90=%.3f p99=%.3f p99.9=%.3f max=%.3f ms\n",
+           n - 1, percentile(dev, n - 1, 50) / 1e6, percentile(dev, n - 1, 90) / 1e6,
+           percentile(dev, n - 1, 99) / 1e6, percentile(dev, n - 1, 99.9) / 1e6, dev[n - 2] / 1e6);
+    printf("[Referee] Wake-up lateness: p50=%.3f p90=%.3f p99=%.3f max=%.3f ms\n",
+           percentile(late, n, 50) / 1e6, percentile(late, n, 90) / 1e6,
+           percentile(late, n, 99) / 1e6, late[n - 1] / 1e6);
+    free(dev);
+    free(late);
+}
@@ -0,0 +1,47 @@
+#ifndef TICK_CLOCK_H
+#define TICK_CLOCK_H
+
+/*
+  tick_clock.h
+  ------------
+  Periodic referee tick driven by a timerfd on CLOCK_MONOTONIC.
+  Deadlines are absolute (start + k * period), so a late wake-up
+  never shifts later ticks; expirations that were slept through
+  are counted as missed ticks instead of being replayed.
+
+  Each wake-up's lateness is kept, so tick-interval jitter can be
+  reported as percentiles: because deadlines sit on an absolute grid,
+  an interval's deviation from the period is the difference between
+  two consecutive latenesses.
+*/
+
+#include <stddef.h>
+
+// ============================
+// TickClock Structure
+// ============================
+typedef struct {
+    int                fd;          // timerfd, -1 when closed
+    long long          periodNs;    // Wall-clock period between ticks
+    long long          firstNs;     // Absolute deadline of the first tick
+    unsigned long long ticks;       // Ticks delivered to the caller
+    unsigned long long missed;      // Expirations skipped because we woke late
+    long long          lastLateNs;  // Lateness of the most recent wake-up
+    long long          maxLateNs;   // Worst lateness seen so far
+    long long*         lateNs;      // Lateness of every wake-up (up to TICK_SAMPLES_MAX)
+    size_t             samples;
+    size_t             capacity;
+} TickClock;
+
+#define TICK_SAMPLES_MAX (1u << 20)
+
+// ============================
+// Function Prototypes
+// ============================
+long long monotonicNs(void);
+int  tickClockOpen(TickClock* clock, long long periodNs, long long firstDelayNs);
+long long tickClockWait(TickClock* clock);
+void tickClockClose(TickClock* clock);
+void printTickJitter(const TickClock* clock);
+
+#endif // TICK_CLOCK_H
@@ -0,0 +1,298 @@
+/*
+============================
+           trace.c
+   Per-process timeline buffers:
+   - traceEmit: reserve a slot, stamp CLOCK_MONOTONIC (signal-safe)
+   - traceDump: players write their buffer to "<trace>.<pid>.bin"
+   - traceWriteJson: the referee merges its buffer and the player
+     dumps into one Chrome trace-event JSON file
+============================
+*/
+
+#define _POSIX_C_SOURCE 200809L
+#include "trace.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+#define TRACE_MAGIC 0x52545052u  // "RPTR"
+
+typedef struct {
+    uint32_t magic;
+    uint32_t count;
+    int32_t  pid;
+    int32_t  playerId;
+    int32_t  team;
+    uint32_t dropped;
+} TraceDumpHeader;
+
+int gTraceOn = 0;
+
+static TraceEvent gEvents[TRACE_CAPACITY];
+static unsigned   gReserved = 0;    // slots handed out (may exceed TRACE_CAPACITY)
+static int        gDumpFD   = -1;   // player dump file, opened up front
+static int        gPlayerId = -1;
+static int        gTeam     = 0;
+
+static int*   gChildPids   = NULL;  // every player process the referee started
+static size_t gChildCount  = 0;
+static size_t gChildCap    = 0;
+
+static const char* gNames[TR_NAME_COUNT] = {
+    "tick", "signalPlayers", "settle", "reorderTeams", "sendFactors",
+    "gatherReports", "collectEnergies",
+    "handleStartPulling", "handleGetReady", "factor pipe read",
+    "handleReportEnergy", "report write"
+};
+
+static const char* gFlowNames[] = { "", "START_PULLING", "GET_READY", "REPORT_ENERGY" };
+
+// ----------------------------
+// traceOpen
+// Enable tracing in this process. A player (playerId >= 0) opens its
+// dump file "<dumpPrefix>.<pid>.bin" now, so traceDump() only needs
+// write(). Returns 0 on success, -1 if the dump file cannot be created.
+// ----------------------------
+int traceOpen(const char* dumpPrefix, int playerId, int team) {
+    gPlayerId = playerId;
+    gTeam     = team;
+    if (dumpPrefix && playerId >= 0) {
+        char path[512];
+        snprintf(path, sizeof(path), "%s.%d.bin", dumpPrefix, (int)getpid());
+        gDumpFD = open(path, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+        if (gDumpFD == -1) {
+            perror("[Player] open trace dump");
+            return -1;
+        }
+    }
+    gTraceOn = 1;
+    return 0;
+}
+
+// ----------------------------
+// traceEmit
+// Record one event. Lock-free and async-signal-safe; events past
+// TRACE_CAPACITY are counted as dropped. Returns the event's slot, or
+// -1 if it was dropped.
+// ----------------------------
+int traceEmit(char phase, int name, uint64_t arg) {
+    unsigned k = __atomic_fetch_add(&gReserved, 1, __ATOMIC_RELAXED);
+    if (k >= TRACE_CAPACITY) return -1;
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    TraceEvent* e = &gEvents[k];
+    e->tsNs  = (int64_t)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+    e->arg   = arg;
+    e->name  = (uint16_t)name;
+    e->phase = phase;
+    return (int)k;
+}
+
+// Blank out an event recorded by this process (it is not exported)
+void traceCancel(int slot) {
+    if (slot >= 0 && slot < (int)TRACE_CAPACITY) gEvents[slot].phase = 0;
+}
+
+static unsigned eventCount(void) {
+    unsigned n = __atomic_load_n(&gReserved, __ATOMIC_RELAXED);
+    return n < TRACE_CAPACITY ? n : TRACE_CAPACITY;
+}
+
+// ----------------------------
+// traceFlowId
+// Same id on both sides of a round trip: kind | tick seq | player ID.
+// Kept below 2^53 so JSON readers hold it exactly.
+// ----------------------------
+uint64_t traceFlowId(TraceFlow kind, uint32_t seq, int playerId) {
+    return ((uint64_t)kind << 40) | ((uint64_t)seq << 8) | (uint8_t)playerId;
+}
+
+TraceFlow traceFlowForSignal(int sig) {
+    switch (sig) {
+        case SIGUSR2: return TRACE_FLOW_START;
+        case SIGUSR1: return TRACE_FLOW_READY;
+        case SIGALRM: return TRACE_FLOW_REPORT;
+        default:      return 0;
+    }
+}
+
+// ----------------------------
+// traceDump
+// Player side: write the buffer to the dump file opened by traceOpen.
+// Only uses write()/close(), so it can run in a SIGTERM handler.
+// ----------------------------
+void traceDump(void) {
+    if (gDumpFD == -1) return;
+    unsigned reserved = __atomic_load_n(&gReserved, __ATOMIC_RELAXED);
+    TraceDumpHeader hdr;
+    hdr.magic    = TRACE_MAGIC;
+    hdr.count    = eventCount();
+    hdr.pid      = (int32_t)getpid();
+    hdr.playerId = gPlayerId;
+    hdr.team     = gTeam;
+    hdr.dropped  = reserved - hdr.count;
+    if (write(gDumpFD, &hdr, sizeof(hdr)) == (ssize_t)sizeof(hdr)) {
+        const char* p = (const char*)gEvents;
+        size_t left = hdr.count * sizeof(TraceEvent);
+        while (left > 0) {
+            ssize_t n = write(gDumpFD, p, left);
+            if (n <= 0) break;
+            p += n;
+            left -= (size_t)n;
+        }
+    }
+    close(gDumpFD);
+    gDumpFD = -1;
+}
+
+// ----------------------------
+// traceNoteChild
+// Referee side: remember a spawned player so its dump is merged.
+// ----------------------------
+void traceNoteChild(int pid) {
+    if (!gTraceOn) return;
+    if (gChildCount == gChildCap) {
+        size_t cap = gChildCap ? gChildCap * 2 : 16;
+        int* grown = realloc(gChildPids, cap * sizeof(int));
+        if (!grown) return;
+        gChildPids = grown;
+        gChildCap  = cap;
+    }
+    gChildPids[gChildCount++] = pid;
+}
+
+// ============================
+// JSON export
+// ============================
+typedef struct {
+    TraceDumpHeader   hdr;
+    const TraceEvent* events;
+    TraceEvent*       owned;   // heap copy for player dumps
+} TraceTrack;
+
+static int loadDump(const char* path, TraceTrack* track) {
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd == -1) return -1;
+    int ok = read(fd, &track->hdr, sizeof(track->hdr)) == (ssize_t)sizeof(track->hdr) &&
+             track->hdr.magic == TRACE_MAGIC && track->hdr.count <= TRACE_CAPACITY;
+    track->owned = NULL;
+    if (ok) {
+        size_t bytes = track->hdr.count * sizeof(TraceEvent);
+        track->owned = malloc(bytes ? bytes : 1);
+        ok = track->owned && read(fd, track->owned, bytes) == (ssize_t)bytes;
+    }
+    close(fd);
+    if (!ok) {
+        free(track->owned);
+        return -1;
+    }
+    track->events = track->owned;
+    return 0;
+}
+
+static void writeTrackEvents(FILE* fp, const TraceTrack* t, int64_t baseNs, int* first) {
+    int pid = t->hdr.pid;
+    int isPlayer = t->hdr.playerId >= 0;
+    for (uint32_t k = 0; k < t->hdr.count; k++) {
+        const TraceEvent* e = &t->events[k];
+        if (e->phase == 0) continue;   // cancelled
+        double us = (e->tsNs - baseNs) / 1000.0;
+        fputs(*first ? "\n" : ",\n", fp);
+        *first = 0;
+        if (e->phase == 'B' || e->phase == 'E') {
+            const char* name = e->name < TR_NAME_COUNT ? gNames[e->name] : "?";
+            fprintf(fp, "{\"name\":\"%s\",\"cat\":\"%s\",\"ph\":\"%c\",\"ts\":%.3f,\"pid\":%d,\"tid\":%d",
+                    name, isPlayer ? "player" : "referee", e->phase, us, pid, pid);
+            if (e->phase == 'B') fprintf(fp, ",\"args\":{\"arg\":%llu}", (unsigned long long)e->arg);
+            fputc('}', fp);
+        } else {
+            const char* name = e->name <= TRACE_FLOW_REPORT ? gFlowNames[e->name] : "?";
+            fprintf(fp, "{\"name\":\"%s\",\"cat\":\"signal\",\"ph\":\"%c\",\"id\":%llu,\"ts\":%.3f,\"pid\":%d,\"tid\":%d%s}",
+                    name, e->phase, (unsigned long long)e->arg, us, pid, pid,
+                    e->phase == 'f' ? ",\"bp\":\"e\"" : "");
+        }
+    }
+}
+
+// ----------------------------
+// traceWriteJson
+// Referee side, after the players have exited: merge every buffer into
+// a trace-event JSON file and remove the player dumps.
+// Returns 0 on success, -1 on error.
+// ----------------------------
+int traceWriteJson(const char* path) {
+    if (!gTraceOn) return 0;
+    gTraceOn = 0;
+
+    size_t nTracks = 1 + gChildCount;
+    TraceTrack* tracks = calloc(nTracks, sizeof(TraceTrack));
+    if (!tracks) {
+        perror("[Referee] trace merge");
+        return -1;
+    }
+    unsigned reserved = __atomic_load_n(&gReserved, __ATOMIC_RELAXED);
+    tracks[0].hdr.count    = eventCount();
+    tracks[0].hdr.pid      = (int32_t)getpid();
+    tracks[0].hdr.playerId = -1;
+    tracks[0].hdr.dropped  = reserved - tracks[0].hdr.count;
+    tracks[0].events       = gEvents;
+
+    size_t loaded = 1, missing = 0;
+    char dump[512];
+    for (size_t c = 0; c < gChildCount; c++) {
+        snprintf(dump, sizeof(dump), "%s.%d.bin", path, gChildPids[c]);
+        if (loadDump(dump, &tracks[loaded]) == 0) {
+            loaded++;
+        } else {
+            missing++;   // killed without a chance to dump (e.g. SIGKILL)
+        }
+        unlink(dump);
+    }
+
+    int64_t baseNs = INT64_MAX;
+    unsigned long long events = 0, dropped = 0;
+    for (size_t t = 0; t < loaded; t++) {
+        if (tracks[t].hdr.count && tracks[t].events[0].tsNs < baseNs) baseNs = tracks[t].events[0].tsNs;
+        events  += tracks[t].hdr.count;
+        dropped += tracks[t].hdr.dropped;
+    }
+
+    FILE* fp = fopen(path, "w");
+    if (!fp) {
+        perror("[Referee] open trace file");
+        for (size_t t = 0; t < loaded; t++) free(tracks[t].owned);
+        free(tracks);
+        return -1;
+    }
+    fputs("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[", fp);
+    int first = 1;
+    for (size_t t = 0; t < loaded; t++) {
+        const TraceDumpHeader* h = &tracks[t].hdr;
+        char label[64];
+        if (h->playerId >= 0) {
+            snprintf(label, sizeof(label), "Player %d (Team %d, pid %d)", h->playerId, h->team, h->pid);
+        } else {
+            snprintf(label, sizeof(label), "Referee (pid %d)", h->pid);
+        }
+        fprintf(fp, "%s{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":%d,\"args\":{\"name\":\"%s\"}}",
+                first ? "\n" : ",\n", h->pid, label);
+        fprintf(fp, ",\n{\"name\":\"process_sort_index\",\"ph\":\"M\",\"pid\":%d,\"args\":{\"sort_index\":%d}}",
+                h->pid, h->playerId >= 0 ? h->playerId : -1);
+        first = 0;
+        writeTrackEvents(fp, &tracks[t], baseNs, &first);
+    }
+    fputs("\n]}\n", fp);
+    fclose(fp);
+
+    printf("[Referee] Trace: %llu events from %zu processes (%llu dropped, %zu players without a dump) -> %s\n",
+           events, loaded, dropped, missing, path);
+    for (size_t t = 0; t < loaded; t++) free(tracks[t].owned);
+    free(tracks);
+    return 0;
+}
@@ -0,0 +1,95 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+/*
+  trace.h
+  -------
+  Low-overhead timeline tracing shared by the referee and the players.
+
+  Each process appends fixed-size events to its own in-memory buffer,
+  timestamped with CLOCK_MONOTONIC (one clock for every process on the
+  host). Recording is a clock read and an array store, so it is safe in
+  signal handlers. Players dump their buffer to "<trace>.<pid>.bin" when
+  terminated; at exit the referee merges its own buffer with every
+  player dump into one Chrome trace-event JSON file (Perfetto /
+  chrome://tracing), one track per process.
+
+  Every signal round trip is a flow (an arrow in the viewer) whose id is
+  built from the signal kind, the tick sequence carried by sigqueue()
+  and the player ID, so both sides derive it independently:
+    referee signalPlayers --> player handler [--> referee gatherReports]
+*/
+
+#include <stdint.h>
+
+// ============================
+// Event names
+// ============================
+typedef enum {
+    // referee
+    TR_TICK,              // one refereeTick()
+    TR_SIGNAL,            // signalPlayers() (arg = signal number)
+    TR_SETTLE,            // usleep after START_PULLING
+    TR_REORDER,           // reorderTeams()
+    TR_SEND_FACTORS,      // sendFactors() (factor pipe writes)
+    TR_GATHER,            // gatherReports()
+    TR_COLLECT,           // collectEnergies() and the round checks
+    // player
+    TR_START_PULLING,     // handleStartPulling()
+    TR_GET_READY,         // handleGetReady()
+    TR_FACTOR_READ,       // read() of the factor pipe
+    TR_REPORT_ENERGY,     // handleReportEnergy()
+    TR_REPORT_WRITE,      // write() of the report record
+    TR_NAME_COUNT
+} TraceName;
+
+// Flow kinds (one per signal with a round trip)
+typedef enum {
+    TRACE_FLOW_START  = 1,   // SIGUSR2 -> handleStartPulling
+    TRACE_FLOW_READY  = 2,   // factor pipe + SIGUSR1 -> handleGetReady
+    TRACE_FLOW_REPORT = 3    // SIGALRM -> handleReportEnergy -> report record
+} TraceFlow;
+
+typedef struct {
+    int64_t  tsNs;     // CLOCK_MONOTONIC
+    uint64_t arg;      // slice argument, or flow id
+    uint16_t name;     // TraceName (for flows: TraceFlow)
+    char     phase;    // 'B', 'E' (slices); 's', 't', 'f' (flows)
+    uint8_t  pad[5];
+} TraceEvent;
+
+#define TRACE_CAPACITY (1u << 16)   // events kept per process; later ones are dropped
+
+extern int gTraceOn;
+
+// ============================
+// Function Prototypes
+// ============================
+int  traceOpen(const char* dumpPath, int playerId, int team);
+int  traceEmit(char phase, int name, uint64_t arg);
+void traceCancel(int slot);
+void traceDump(void);
+void traceNoteChild(int pid);
+int  traceWriteJson(const char* path);
+
+uint64_t traceFlowId(TraceFlow kind, uint32_t seq, int playerId);
+TraceFlow traceFlowForSignal(int sig);
+
+static inline void traceBegin(TraceName name, uint64_t arg) {
+    if (gTraceOn) traceEmit('B', name, arg);
+}
+static inline void traceEnd(TraceName name) {
+    if (gTraceOn) traceEmit('E', name, 0);
+}
+static inline void traceFlow(char phase, TraceFlow kind, uint32_t seq, int playerId) {
+    if (gTraceOn && kind) traceEmit(phase, kind, traceFlowId(kind, seq, playerId));
+}
+
+// Start of a flow, recorded before the signal or message it stands for
+// (the receiver may log the end before sigqueue()/send() returns).
+// Returns the slot to traceCancel() if the send fails, or -1.
+static inline int traceFlowStart(TraceFlow kind, uint32_t seq, int playerId) {
+    return gTraceOn && kind ? traceEmit('s', kind, traceFlowId(kind, seq, playerId)) : -1;
+}
+
+#endif // TRACE_H
@@ -0,0 +1,186 @@
+/*
+============================
+         transport.c
+   Socket endpoints for the referee <-> player socket transport:
+   - "unix:<path>" / "tcp:<host>:<port>" address parsing
+   - Listening (referee) and connecting with retries (player)
+============================
+*/
+
+#define _GNU_SOURCE   // accept4
+#include "transport.h"
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <netdb.h>
+#include <time.h>
+#include <unistd.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/un.h>
+
+#define CONNECT_RETRY_NS 50000000LL   // between attempts while the referee starts up
+
+static long long nowNs(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (long long)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+// ----------------------------
+// parseTransportAddr
+// Returns 0 on success, -1 (with a message) on a malformed address or
+// an unknown host.
+// ----------------------------
+int parseTransportAddr(const char* spec, TransportAddr* out) {
+    memset(out, 0, sizeof(*out));
+    if (strncmp(spec, "unix:", 5) == 0) {
+        const char* path = spec + 5;
+        struct sockaddr_un* un = (struct sockaddr_un*)&out->addr;
+        if (*path == '\0' || strlen(path) >= sizeof(un->sun_path)) {
+            fprintf(stderr, "Bad unix socket path in '%s'\n", spec);
+            return -1;
+        }
+        un->sun_family = AF_UNIX;
+        strcpy(un->sun_path, path);
+        strcpy(out->path, path);
+        out->family = AF_UNIX;
+        out->len    = sizeof(*un);
+        return 0;
+    }
+    if (strncmp(spec, "tcp:", 4) == 0) {
+        char host[256];
+        const char* colon = strrchr(spec + 4, ':');
+        size_t hostLen = colon ? (size_t)(colon - (spec + 4)) : 0;
+        if (!colon || colon[1] == '\0' || hostLen >= sizeof(host)) {
+            fprintf(stderr, "Bad tcp address '%s' (expected tcp:<host>:<port>)\n", spec);
+            return -1;
+        }
+        memcpy(host, spec + 4, hostLen);
+        host[hostLen] = '\0';
+
+        struct addrinfo hints, *res = NULL;
+        memset(&hints, 0, sizeof(hints));
+        hints.ai_family   = AF_UNSPEC;
+        hints.ai_socktype = SOCK_STREAM;
+        hints.ai_flags    = AI_PASSIVE;   // empty host = any interface
+        int rc = getaddrinfo(hostLen ? host : NULL, colon + 1, &hints, &res);
+        if (rc != 0) {
+            fprintf(stderr, "Cannot resolve '%s': %s\n", spec, gai_strerror(rc));
+            return -1;
+        }
+        memcpy(&out->addr, res->ai_addr, res->ai_addrlen);
+        out->len    = res->ai_addrlen;
+        out->family = res->ai_family;
+        freeaddrinfo(res);
+        return 0;
+    }
+    fprintf(stderr, "Unknown transport address '%s' (use unix:<path> or tcp:<host>:<port>)\n", spec);
+    return -1;
+}
+
+static void setNoDelay(int fd, int family) {
+    if (family != AF_UNIX) {
+        int one = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    }
+}
+
+// ----------------------------
+// listenTransport
+// Referee side. A stale unix socket file from an earlier run is
+// replaced. Returns a non-blocking listening fd, or -1.
+// ----------------------------
+int listenTransport(const TransportAddr* addr) {
+    int fd = socket(addr->family, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd == -1) {
+        perror("socket");
+        return -1;
+    }
+    if (addr->family == AF_UNIX) {
+        unlink(addr->path);
+    } else {
+        int one = 1;
+        setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+    }
+    if (bind(fd, (const struct sockaddr*)&addr->addr, addr->len) == -1 || listen(fd, 64) == -1) {
+        perror("bind/listen");
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+// ----------------------------
+// acceptTransport
+// Referee side. Returns a non-blocking connection, or -1 when none is
+// waiting (EAGAIN) or on error.
+// ----------------------------
+int acceptTransport(int listenFD, const TransportAddr* addr) {
+    int fd = accept4(listenFD, NULL, NULL, SOCK_NONBLOCK | SOCK_CLOEXEC);
+    if (fd == -1) {
+        if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) perror("accept");
+        return -1;
+    }
+    setNoDelay(fd, addr->family);
+    return fd;
+}
+
+// ----------------------------
+// connectTransport
+// Player side: keep trying for up to timeoutNs while the referee is not
+// listening yet. Returns a blocking connected fd, or -1.
+// ----------------------------
+int connectTransport(const TransportAddr* addr, long long timeoutNs) {
+    long long deadline = nowNs() + timeoutNs;
+    for (;;) {
+        int fd = socket(addr->family, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        if (fd == -1) {
+            perror("socket");
+            return -1;
+        }
+        if (connect(fd, (const struct sockaddr*)&addr->addr, addr->len) == 0) {
+            setNoDelay(fd, addr->family);
+            return fd;
+        }
+        int err = errno;
+        close(fd);
+        if ((err != ECONNREFUSED && err != ENOENT && err != EAGAIN) || nowNs() >= deadline) {
+            errno = err;
+            perror("connect");
+            return -1;
+        }
+        struct timespec nap = { 0, CONNECT_RETRY_NS };
+        nanosleep(&nap, NULL);
+    }
+}
+
+// ----------------------------
+// closeTransport
+// Close a listener and remove its unix socket file.
+// ----------------------------
+void closeTransport(int fd, const TransportAddr* addr) {
+    if (fd != -1) close(fd);
+    if (addr->family == AF_UNIX && addr->path[0]) unlink(addr->path);
+}
+
+// ----------------------------
+// readFull
+// Read exactly len bytes. Returns 1 on success, 0 on end of stream,
+// -1 on error.
+// ----------------------------
+int readFull(int fd, void* buf, size_t len) {
+    char* p = buf;
+    while (len > 0) {
+        ssize_t n = read(fd, p, len);
+        if (n == 0) return 0;
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return -1;
+        }
+        p += n;
+        len -= (size_t)n;
+    }
+    return 1;
+}
@@ -0,0 +1,34 @@
+#ifndef TRANSPORT_H
+#define TRANSPORT_H
+
+/*
+  transport.h
+  -----------
+  Stream-socket endpoints for the socket transport between the referee
+  and its players (see protocol.h), shared by both sides.
+
+  Addresses are written "unix:<path>" or "tcp:<host>:<port>"
+  (an empty host listens on every interface).
+*/
+
+#include <stddef.h>
+#include <sys/socket.h>
+
+typedef struct {
+    int                     family;   // AF_UNIX or AF_INET/AF_INET6
+    struct sockaddr_storage addr;
+    socklen_t               len;
+    char                    path[108]; // AF_UNIX path (removed when the listener closes)
+} TransportAddr;
+
+// ============================
+// Function Prototypes
+// ============================
+int  parseTransportAddr(const char* spec, TransportAddr* out);
+int  listenTransport(const TransportAddr* addr);
+int  acceptTransport(int listenFD, const TransportAddr* addr);
+int  connectTransport(const TransportAddr* addr, long long timeoutNs);
+void closeTransport(int fd, const TransportAddr* addr);
+int  readFull(int fd, void* buf, size_t len);
+
+#endif // TRANSPORT_H